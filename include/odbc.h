@@ -1,12 +1,36 @@
 #pragma once
 
 #include <map>
+#include <list>
+#include <unordered_map>
 #include <string>
 #include <deque>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <utility>
 #include <memory>
+#include <atomic>
+#include <memory_resource>
+#include <functional>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <charconv>
+#include <ctime>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <shared_mutex>
 #include <thread>
 #include <sstream>
+#include <random>
+#include <limits>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#endif
 #include <sql.h>
 #include <sqlext.h>
 #include "msodbcsql.h"
@@ -14,7 +38,7 @@
 #pragma comment(lib, "odbc32.lib")
 #pragma comment(lib, "odbccp32.lib")
 
-// TODO:: Net   ̽ üؾ.
+// TODO:: Net에서 공통적으로 사용될 인터페이스로 대체해야함.
 class ILogging
 {
 public:
@@ -78,10 +102,22 @@ public:
 		Critical = 2,
 	};
 
+	// 재시도 정책 등에서 사용하는 에러 분류 (SQLSTATE, native error 기준)
+	enum class eErrorClass
+	{
+		None = 0,
+		Deadlock,	// 40001, 1205
+		Timeout,	// HYT00, HYT01
+		Connection,	// 08xxx
+		Other,
+		Max
+	};
+
 	explicit OdbcError(SQLSMALLINT handleType, SQLHANDLE handle)
 		: m_handleType(handleType)
 		, m_handle(handle)
 		, m_errorLevel(eErrorLevel::NoError)
+		, m_errorClass(eErrorClass::None)
 	{
 	}
 
@@ -90,35 +126,35 @@ public:
 	inline std::string_view GetState() { return m_state; }
 	inline std::string_view GetMessage() { return m_message; }
 	inline bool IsCritical() { return (eErrorLevel::Critical == m_errorLevel); }
+	inline SQLINTEGER GetNativeError() { return m_nativeError; }
+	inline eErrorClass GetErrorClass() { return m_errorClass; }
 
 	SQLRETURN Parse()
 	{
-		static constexpr SQLSMALLINT STATUS_RECORD_NUMBER = 1;  // ·ڵ  1 
+		static constexpr SQLSMALLINT STATUS_RECORD_NUMBER = 1;  // 상태레코드 값 1 고정
 
-		m_state.resize(16);
-		m_message.resize(1024);
-		SQLSMALLINT messageTextLength = static_cast<SQLSMALLINT>(m_message.length());
+		SQLSMALLINT messageTextLength = 1024;
 		SQLSMALLINT textLength = 0;
 
 		do
 		{
+			m_state.resize(16);
+			m_message.resize(messageTextLength);
+
 			auto sqlResultCode = SQLGetDiagRec(
 				m_handleType,
 				m_handle,
 				STATUS_RECORD_NUMBER,
 				reinterpret_cast<uint8_t*>(m_state.data()),
-				NULL,
+				&m_nativeError,
 				reinterpret_cast<uint8_t*>(m_message.data()),
 				messageTextLength,
 				&textLength);
 			// 
 			if (SQL_SUCCESS_WITH_INFO == sqlResultCode && m_message.length() <= textLength)
 			{
-				// 2 
-				m_state = "";
-				m_message = "";
+				// 2배 증가
 				messageTextLength <<= 1;
-				m_message.resize(messageTextLength);
 				continue;
 			}
 
@@ -130,11 +166,26 @@ public:
 			break;
 		} while (true);
 
+		// 버퍼의 남은 공간(null 문자)을 제거해야 상태 값을 비교할 수 있다.
+		m_state.resize(std::strlen(m_state.c_str()));
+		m_message.resize((std::min)(static_cast<size_t>(textLength), std::strlen(m_message.c_str())));
+
 		m_errorLevel = JudgeErrorLevelAndGet();
+		m_errorClass = JudgeErrorClassAndGet();
 
 		return SQL_SUCCESS;
 	}
 
+	// 드라이버가 아닌 라이브러리에서 확인한 에러를 기록한다.
+	void SetError(std::string_view state, std::string_view message)
+	{
+		m_state = state;
+		m_message = message;
+
+		m_errorLevel = JudgeErrorLevelAndGet();
+		m_errorClass = JudgeErrorClassAndGet();
+	}
+
 	std::string ToString()
 	{
 		std::stringstream ss;
@@ -148,9 +199,10 @@ public:
 private:
 	eErrorLevel JudgeErrorLevelAndGet()
 	{
-		if (0 == m_state.compare("08S01")		// communication link failure.
-			|| 0 == m_state.compare("08S02")	// Physical connection is not usable.
-			|| 0 == m_state.compare("HY000"))
+		// 연결을 폐기하는 에러이므로 연결 예외(08xxx)로 한정한다.
+		// ex) 08S01 communication link failure, 08S02 physical connection is not usable
+		// HY000(일반 에러)은 드라이버가 연결과 무관한 에러에도 사용하므로 포함하지 않는다.
+		if (0 == m_state.compare(0, 2, "08"))	// connection exception
 		{
 			return eErrorLevel::Critical;
 		}
@@ -158,9 +210,34 @@ private:
 		return eErrorLevel::Normal;
 	}
 
+	eErrorClass JudgeErrorClassAndGet()
+	{
+		static constexpr SQLINTEGER SQLSERVER_DEADLOCK_VICTIM = 1205;
+
+		if (0 == m_state.compare("40001") || SQLSERVER_DEADLOCK_VICTIM == m_nativeError)
+		{
+			return eErrorClass::Deadlock;
+		}
+
+		if (0 == m_state.compare("HYT00")		// timeout expired
+			|| 0 == m_state.compare("HYT01"))	// connection timeout expired
+		{
+			return eErrorClass::Timeout;
+		}
+
+		if (0 == m_state.compare(0, 2, "08"))
+		{
+			return eErrorClass::Connection;
+		}
+
+		return eErrorClass::Other;
+	}
+
 	SQLSMALLINT m_handleType = 0;
 	SQLHANDLE m_handle = SQL_NULL_HANDLE;
 	eErrorLevel m_errorLevel;
+	eErrorClass m_errorClass;
+	SQLINTEGER m_nativeError = 0;
 	std::string m_state;
 	std::string m_message;
 };
@@ -286,10 +363,137 @@ struct SqlTypes<float>
 template <>
 struct SqlTypes<double>
 {
-	static constexpr int16_t CTYPE = SQL_C_DOUBLE;
+	static constexpr int16_t C_TYPE = SQL_C_DOUBLE;
 	static constexpr int16_t SQL_TYPE = SQL_DOUBLE;
 };
 
+// 힙 할당 없이 파라미터로 사용할 수 있는 고정 크기 문자열 (최대 Capacity 바이트)
+// 길이를 함께 보관하여 바인딩 시 길이 지시자(StrLen_or_IndPtr)로 사용한다.
+// 생성자와 대입 연산자는 Capacity를 넘는 문자열을 자르므로 길이를 알 수 없는 값은 Assign 결과를 확인한다.
+// (Query::SetParameter는 Assign으로 대입하며 잘린 경우 false를 반환한다.)
+template <size_t Capacity>
+class FixedString
+{
+public:
+	FixedString() = default;
+
+	FixedString(std::string_view value)
+	{
+		Assign(value);
+	}
+
+	FixedString(const char* value)
+		: FixedString(std::string_view(value))
+	{
+	}
+
+	FixedString(const std::string& value)
+		: FixedString(std::string_view(value))
+	{
+	}
+
+	FixedString& operator=(std::string_view value)
+	{
+		Assign(value);
+		return *this;
+	}
+
+	FixedString& operator=(const char* value)
+	{
+		Assign(value);
+		return *this;
+	}
+
+	FixedString& operator=(const std::string& value)
+	{
+		Assign(value);
+		return *this;
+	}
+
+	// Capacity를 넘는 문자열은 잘리며 false를 반환한다.
+	bool Assign(std::string_view value)
+	{
+		size_t length = (std::min)(value.size(), Capacity);
+		memcpy(m_data, value.data(), length);
+		m_data[length] = 0;
+		m_length = static_cast<SQLLEN>(length);
+
+		return (length == value.size());
+	}
+
+	inline const char* GetData() const { return m_data; }
+	inline size_t GetLength() const { return static_cast<size_t>(m_length); }
+	inline const SQLLEN* GetIndicator() const { return &m_length; }
+	static constexpr size_t GetCapacity() { return Capacity; }
+
+	operator std::string_view() const { return std::string_view(m_data, GetLength()); }
+
+private:
+	char m_data[Capacity + 1] = { 0x00, };
+	SQLLEN m_length = 0;
+};
+
+template <size_t Capacity>
+struct SqlTypes<FixedString<Capacity>>
+{
+	static constexpr int16_t C_TYPE = SQL_C_CHAR;
+	static constexpr int16_t SQL_TYPE = SQL_VARCHAR;
+};
+
+template <typename T>
+struct IsFixedString : std::false_type {};
+
+template <size_t Capacity>
+struct IsFixedString<FixedString<Capacity>> : std::true_type {};
+
+// 실행 시점(data-at-execution)에 청크 단위로 전송하는 파라미터 데이터
+class IParamStream
+{
+public:
+	virtual ~IParamStream() = default;
+
+	// 전송할 전체 바이트 수. 알 수 없으면 -1
+	virtual SQLLEN GetLength() = 0;
+
+	// 실행마다 처음부터 다시 전송할 수 있도록 위치를 되돌린다.
+	virtual bool Rewind() = 0;
+
+	// buffer에 최대 size 바이트를 채우고 채운 크기를 반환한다. 0이면 전송 완료, 음수면 실패
+	virtual SQLLEN Read(char* buffer, SQLLEN size) = 0;
+};
+
+// 메모리 버퍼를 청크 단위로 전송한다. 버퍼는 실행이 끝날 때까지 유지되어야 한다.
+class MemoryParamStream : public IParamStream
+{
+public:
+	MemoryParamStream(const void* data, size_t length)
+		: m_data(static_cast<const char*>(data)), m_length(length)
+	{
+	}
+
+	SQLLEN GetLength() override { return static_cast<SQLLEN>(m_length); }
+
+	bool Rewind() override
+	{
+		m_offset = 0;
+		return true;
+	}
+
+	SQLLEN Read(char* buffer, SQLLEN size) override
+	{
+		size_t count = (std::min)(m_length - m_offset, static_cast<size_t>(size));
+		memcpy(buffer, m_data + m_offset, count);
+		m_offset += count;
+
+		return static_cast<SQLLEN>(count);
+	}
+
+private:
+	const char* m_data = nullptr;
+	size_t m_length = 0;
+	size_t m_offset = 0;
+};
+
 class Statement
 {
 public:
@@ -301,6 +505,25 @@ public:
 		CLOSE = 3
 	};
 
+	// 레코드셋이 열릴 때 1회 조회하여 보관하는 컬럼 정보
+	struct ColumnInfo
+	{
+		std::string name;
+		SQLSMALLINT type = 0;
+		SQLULEN size = 0;
+		SQLSMALLINT decimalDigits = 0;
+		SQLSMALLINT nullable = 0;
+	};
+
+	// row-wise 바인딩 시 사용자 row 버퍼 내 컬럼 위치
+	struct RowBinding
+	{
+		SQLSMALLINT cType = SQL_C_CHAR;
+		size_t offset = 0;
+		SQLLEN width = 0;
+		size_t indicatorOffset = 0;
+	};
+
 	inline bool IsOpen()
 	{
 		return (nullptr != m_hStmt);
@@ -318,11 +541,41 @@ public:
 		m_index_recordset = 0;
 		m_fetchResult = eFetchResult::CLOSE;
 
+		// 블록 커서 바인딩 해제
+		UnbindColumns();
+		m_rowArraySize = 1;
+		m_described = false;
+
+		// 파라미터 배열 해제
+		if (1 != m_paramSetSize)
+		{
+			SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(1), 0);
+			SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAM_STATUS_PTR, nullptr, 0);
+			SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, nullptr, 0);
+			m_paramSetSize = 1;
+		}
+
+		// 스트림 전송 중 실패하였다면 실행을 취소해야 핸들을 재사용할 수 있다.
+		if (true == m_needData)
+		{
+			SQLCancel(m_hStmt);
+			m_needData = false;
+		}
+
+		if (true == m_async)
+		{
+			SetAsync(false);
+		}
+		m_streamIndicators.clear();
+		m_streamChunkSize = DEFAULT_STREAM_CHUNK_SIZE;
+
 		// close cursor.
 		SQLCloseCursor(m_hStmt);
 
 		// execute result close. (SQL_CLOSE, SQL_DROP, SQL_UNBIND, SQL_RESET_PARAMS)
+		// 준비된 실행 계획은 유지되므로 동일 스크립트는 Prepare 없이 재실행할 수 있다.
 		SQLFreeStmt(m_hStmt, SQL_CLOSE);
+		SQLFreeStmt(m_hStmt, SQL_RESET_PARAMS);
 	}
 
 	void Destroy()
@@ -334,6 +587,7 @@ public:
 
 		SQLFreeHandle(SQL_HANDLE_STMT, m_hStmt);
 		m_hStmt = SQL_NULL_HANDLE;
+		m_prepared = false;
 	}
 
 	inline int GetRecordsetIndex() { return m_index_recordset; }
@@ -342,18 +596,162 @@ public:
 
 	inline bool IsNoData() { return (eFetchResult::EMPTY == m_fetchResult); }
 
+	// 마지막 ResetReadCount 이후 읽은 row 수와 컬럼 데이터 크기 (byte)
+	inline uint64_t GetReadRowCount() { return m_readRowCount; }
+	inline uint64_t GetReadByteCount() { return m_readByteCount; }
+
+	inline void ResetReadCount()
+	{
+		m_readRowCount = 0;
+		m_readByteCount = 0;
+	}
+
 	inline bool Ok() { return false; }
 
+	// 1보다 클 경우 레코드셋이 열릴 때 컬럼 버퍼를 바인딩하여 SQLFetch 1회에 size 만큼의 row를 읽는다.
+	// 바인딩 할 수 없는 컬럼(LOB 등)이 있는 레코드셋은 기존과 같이 row 단위로 읽는다.
+	inline void SetRowArraySize(SQLULEN size) { m_rowArraySize = (0 == size) ? 1 : size; }
+
+	inline SQLULEN GetRowArraySize() { return m_rowArraySize; }
+
+	inline bool IsBulk() { return m_bulk; }
+
+	// 이미 읽은 블록에 다음 row가 남아있는지 확인한다.
+	inline bool HasBufferedRow() { return (true == m_bulk && m_index_row + 1 < m_rowsFetched); }
+
+	inline SQLUSMALLINT GetRowStatus(SQLULEN row) { return m_rowStatus[row]; }
+
+	// 현재 위치 이후의 row를 사용자 row 버퍼(stride 크기의 배열)에 row-wise로 바인딩한다.
+	// 이후 FetchRows 호출마다 최대 capacity 개의 row가 buffer에 채워진다.
+	bool BindRows(const RowBinding* bindings, SQLUSMALLINT count, void* buffer, SQLULEN stride, SQLULEN capacity)
+	{
+		UnbindColumns();
+
+		m_rowStatus.resize(capacity);
+
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_BIND_TYPE, reinterpret_cast<SQLPOINTER>(stride), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(capacity), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_STATUS_PTR, m_rowStatus.data(), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROWS_FETCHED_PTR, &m_rowsFetched, 0);
+
+		m_rowWise = true;
+
+		auto base = static_cast<char*>(buffer);
+		for (SQLUSMALLINT i = 0; i < count; ++i)
+		{
+			const auto& binding = bindings[i];
+			SQLRETURN ret = SQLBindCol(m_hStmt, i + 1, binding.cType, base + binding.offset, binding.width, reinterpret_cast<SQLLEN*>(base + binding.indicatorOffset));
+			if (!(ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// BindRows로 바인딩된 버퍼에 다음 블록을 읽는다. 더 이상 row가 없으면 SQL_NO_DATA를 반환한다.
+	SQLRETURN FetchRows(SQLULEN& out_fetched)
+	{
+		out_fetched = 0;
+		m_rowsFetched = 0;
+		m_fetchResult = eFetchResult::ERR;
+
+		SQLRETURN retcode = SQLFetch(m_hStmt);
+		if (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO)
+		{
+			out_fetched = m_rowsFetched;
+			m_fetchResult = eFetchResult::OK;
+			m_readRowCount += m_rowsFetched;
+		}
+		else if (SQL_NO_DATA == retcode)
+		{
+			UnbindColumns();
+			m_fetchResult = eFetchResult::EMPTY;
+		}
+
+		return retcode;
+	}
+
+	inline bool IsPrepared() { return m_prepared; }
+
+	// 비동기 실행 모드(폴링). Prepare, Execute가 완료 전에 SQL_STILL_EXECUTING을 반환하며
+	// 완료될 때까지 동일한 함수를 다시 호출하여 상태를 확인한다.
+	// 드라이버가 지원하지 않을 경우 false를 반환하며 동기로 실행된다.
+	bool SetAsync(bool enable)
+	{
+		SQLULEN value = (true == enable) ? SQL_ASYNC_ENABLE_ON : SQL_ASYNC_ENABLE_OFF;
+		SQLRETURN retcode = SQLSetStmtAttr(m_hStmt, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(value), 0);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			return false;
+		}
+
+		m_async = enable;
+		return true;
+	}
+
+	inline bool IsAsync() { return m_async; }
+
+	// 실행 중인 요청을 취소한다. 비동기 실행 중이라면 실행 중인 함수를 다시 호출하여 완료(HY008)를 확인해야 한다.
+	inline SQLRETURN Cancel() { return SQLCancel(m_hStmt); }
+
+	// SQL_STILL_EXECUTING을 반환한 함수를 다시 호출하기 전에 대기한다.
+	// 처음 몇 번은 양보만 하고 이후에는 잠시 쉬어 CPU를 점유하지 않는다.
+	static void WaitStillExecuting(int32_t& count)
+	{
+		if (++count < STILL_EXECUTING_YIELD_COUNT)
+		{
+			std::this_thread::yield();
+			return;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// 실행 제한 시간 (초, 0일 경우 제한 없음). 초과하면 HYT00으로 실패한다.
+	bool SetQueryTimeout(SQLULEN seconds)
+	{
+		SQLRETURN retcode = SQLSetStmtAttr(m_hStmt, SQL_ATTR_QUERY_TIMEOUT, reinterpret_cast<SQLPOINTER>(seconds), 0);
+		return (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO);
+	}
+
+	// 다른 스크립트로 재사용할 경우 다시 Prepare 하도록 한다.
+	inline void Unprepare() { m_prepared = false; }
+
 	SQLRETURN Prepare(const char* statementText)
 	{
-		return SQLPrepare(m_hStmt, (SQLCHAR*)statementText, SQL_NTS);
+		SQLRETURN retcode = SQLPrepare(m_hStmt, (SQLCHAR*)statementText, SQL_NTS);
+		m_prepared = (SQL_SUCCESS == retcode || SQL_SUCCESS_WITH_INFO == retcode);
+
+		return retcode;
 	}
 
 	SQLRETURN Execute()
 	{
-		return SQLExecute(m_hStmt);
+		UnbindColumns();
+		m_described = false;
+
+		SQLRETURN retcode = SQLExecute(m_hStmt);
+		if (SQL_NEED_DATA == retcode)
+		{
+			retcode = PutStreams();
+		}
+
+		return retcode;
 	}
 
+	// 스트림 파라미터 및 LOB 컬럼을 읽을 때 사용하는 청크 크기
+	inline void SetStreamChunkSize(SQLLEN size) { m_streamChunkSize = (std::max)(size, static_cast<SQLLEN>(MIN_STREAM_CHUNK_SIZE)); }
+
+	inline SQLLEN GetStreamChunkSize() { return m_streamChunkSize; }
+
+	// 실행 중 임시 버퍼(RowSchema 블록 버퍼 등)에 사용할 메모리 리소스
+	// 실행 단위 arena가 설정되지 않은 경우 기본 리소스를 반환한다.
+	inline std::pmr::memory_resource* GetMemoryResource() { return (nullptr == m_memoryResource) ? std::pmr::get_default_resource() : m_memoryResource; }
+
+	inline void SetMemoryResource(std::pmr::memory_resource* resource) { m_memoryResource = resource; }
+
 	bool MoveNext()
 	{
 		auto retCode = Fetch();
@@ -367,6 +765,10 @@ public:
 
 	bool MoveNextRecordSet()
 	{
+		// 이전 레코드셋의 컬럼 바인딩 및 정보는 다음 레코드셋에 사용할 수 없다.
+		UnbindColumns();
+		m_described = false;
+
 		SQLRETURN retcode = SQLMoreResults(m_hStmt);
 		if (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO)
 		{
@@ -387,15 +789,33 @@ public:
 
 		m_fetchResult = eFetchResult::ERR;
 
-		SQLSMALLINT column_count = 0;
-		retcode = SQLNumResultCols(m_hStmt, &column_count);
-		if (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO || retcode == SQL_NO_DATA)
+		if (true == m_bulk)
 		{
-			if (column_count == 0)
+			// 이미 읽은 블록에 남은 row가 있다면 드라이버 호출 없이 이동한다.
+			if (++m_index_row < m_rowsFetched)
 			{
-				m_fetchResult = eFetchResult::EMPTY;
-				return SQL_NO_DATA;
+				return SeekBoundRow();
 			}
+
+			return FetchBlock();
+		}
+
+		// 컬럼 정보는 레코드셋이 열린 후 첫 Fetch에서만 조회한다.
+		bool opened = (false == m_described);
+		if (true == opened)
+		{
+			DescribeColumns();
+		}
+
+		if (0 == GetColumnCount())
+		{
+			m_fetchResult = eFetchResult::EMPTY;
+			return SQL_NO_DATA;
+		}
+
+		if (true == opened && 1 < m_rowArraySize && true == BindColumns())
+		{
+			return FetchBlock();
 		}
 
 		retcode = SQLFetch(m_hStmt);
@@ -407,6 +827,10 @@ public:
 			{
 				m_fetchResult = eFetchResult::EMPTY;
 			}
+			else
+			{
+				++m_readRowCount;
+			}
 		}
 
 		return retcode;
@@ -438,6 +862,22 @@ public:
 		return false;
 	}
 
+	// string_view는 종료 문자가 없으므로 길이를 indicator에 기록하여 바인딩한다.
+	// indicator는 실행이 끝날 때까지 유지되어야 한다.
+	bool AddParam(std::string_view value, SQLLEN& indicator)
+	{
+		indicator = static_cast<SQLLEN>(value.size());
+		SQLULEN columnSize = (std::max)(value.size(), static_cast<size_t>(1));
+		return (SQLBindParameter(m_hStmt, ++m_index_param, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, columnSize, 0, const_cast<char*>(value.data()), indicator, &indicator) == SQL_SUCCESS);
+	}
+
+	template <size_t Capacity>
+	bool AddParam(const FixedString<Capacity>& value)
+	{
+		using _types_t = SqlTypes<FixedString<Capacity>>;
+		return (SQLBindParameter(m_hStmt, ++m_index_param, SQL_PARAM_INPUT, _types_t::C_TYPE, _types_t::SQL_TYPE, Capacity, 0, const_cast<char*>(value.GetData()), Capacity + 1, const_cast<SQLLEN*>(value.GetIndicator())) == SQL_SUCCESS);
+	}
+
 	bool AddParam(const char* value, int32_t len)
 	{
 		if (SQLBindParameter(m_hStmt, ++m_index_param, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, len, 0, const_cast<char*>(value), len, 0) == SQL_SUCCESS)
@@ -459,39 +899,139 @@ public:
 		return false;
 	}
 
+	// 스트림 파라미터는 바인딩 시점이 아닌 Execute 시점에 청크 단위로 전송된다. (varbinary(max), varchar(max) ...)
+	// stream은 실행이 끝날 때까지 유지되어야 한다.
+	bool AddParam(IParamStream* stream, SQLSMALLINT sqlType = SQL_LONGVARBINARY)
+	{
+		SQLSMALLINT cType = SQL_C_BINARY;
+		if (SQL_LONGVARCHAR == sqlType || SQL_VARCHAR == sqlType)
+		{
+			cType = SQL_C_CHAR;
+		}
+		else if (SQL_WLONGVARCHAR == sqlType || SQL_WVARCHAR == sqlType)
+		{
+			cType = SQL_C_WCHAR;
+		}
+
+		SQLLEN length = stream->GetLength();
+		m_streamIndicators.push_back((length < 0) ? SQL_DATA_AT_EXEC : SQL_LEN_DATA_AT_EXEC(length));
+
+		SQLULEN columnSize = (length < 0) ? 0 : static_cast<SQLULEN>(length);
+		return (SQLBindParameter(m_hStmt, ++m_index_param, SQL_PARAM_INPUT, cType, sqlType, columnSize, 0, stream, 0, &m_streamIndicators.back()) == SQL_SUCCESS);
+	}
+
+	// 파라미터 배열(column-wise)로 size 개의 파라미터 셋을 한번에 실행하도록 설정한다.
+	// 실행 후 status에 파라미터 셋별 결과(SQL_PARAM_SUCCESS, SQL_PARAM_ERROR ...)가 기록된다.
+	bool SetParamSetSize(SQLULEN size, SQLUSMALLINT* status, SQLULEN* processed)
+	{
+		m_paramSetSize = size;
+
+		return (SQL_SUCCESS == SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAM_BIND_TYPE, reinterpret_cast<SQLPOINTER>(SQL_PARAM_BIND_BY_COLUMN), 0)
+			&& SQL_SUCCESS == SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(size), 0)
+			&& SQL_SUCCESS == SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAM_STATUS_PTR, status, 0)
+			&& SQL_SUCCESS == SQLSetStmtAttr(m_hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, processed, 0));
+	}
+
+	inline SQLULEN GetParamSetSize() { return m_paramSetSize; }
+
+	// values는 파라미터 셋 수 만큼의 배열
+	template <typename T>
+	bool AddParamArray(const T* values, SQLLEN* indicators)
+	{
+		return (SQLBindParameter
+		(
+			m_hStmt,
+			++m_index_param,
+			SQL_PARAM_INPUT,
+			SqlTypes<T>::C_TYPE,
+			SqlTypes<T>::SQL_TYPE,
+			sizeof(T),
+			0,
+			const_cast<T*>(values),
+			sizeof(T),
+			indicators
+		) == SQL_SUCCESS);
+	}
+
+	// values는 width 크기의 문자열이 파라미터 셋 수 만큼 연속된 버퍼이며 indicators에 각 길이가 기록된다.
+	bool AddParamArray(const char* values, SQLLEN width, SQLLEN* indicators)
+	{
+		SQLULEN columnSize = static_cast<SQLULEN>((std::max)(width - 1, static_cast<SQLLEN>(1)));
+		return (SQLBindParameter(m_hStmt, ++m_index_param, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, columnSize, 0, const_cast<char*>(values), width, indicators) == SQL_SUCCESS);
+	}
+
 	template <typename T>
 	void ReadData(T& value)
 	{
+		if (true == m_bulk)
+		{
+			ReadBoundData(value);
+			return;
+		}
+
 		if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SqlTypes<T>::C_TYPE, static_cast<SQLPOINTER>(&value), sizeof(T), nullptr))
 		{
 			throw StatementException(GetError());
 		}
+
+		m_readByteCount += sizeof(T);
 	}
 
 	void ReadData(char* data, int32_t len)
 	{
-		if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SQL_C_CHAR, static_cast<SQLPOINTER>(data), len, nullptr))
+		if (true == m_bulk)
+		{
+			ReadBoundText(data, len);
+			return;
+		}
+
+		SQLLEN indicator = 0;
+		if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SQL_C_CHAR, static_cast<SQLPOINTER>(data), len, &indicator))
 		{
 			throw StatementException(GetError());
 		}
+
+		AddReadBytes(indicator, len);
 	}
 
 	void ReadData(wchar_t* data, int32_t len)
 	{
-		if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SQL_C_WCHAR, static_cast<SQLPOINTER>(data), len, nullptr))
+		if (true == m_bulk)
+		{
+			ReadBoundText(data, len);
+			return;
+		}
+
+		SQLLEN indicator = 0;
+		if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SQL_C_WCHAR, static_cast<SQLPOINTER>(data), len, &indicator))
 		{
 			throw StatementException(GetError());
 		}
+
+		AddReadBytes(indicator, len);
 	}
 
-	void ReadData_TimeStamp(struct tm& timeinfo)
+	void ReadData_TimeStamp(TIMESTAMP_STRUCT& ts)
 	{
-		TIMESTAMP_STRUCT ts;
 		//SQLLEN len;
-		if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SQL_C_TYPE_TIMESTAMP, static_cast<SQLPOINTER>(&ts), sizeof(TIMESTAMP_STRUCT), nullptr))
+		if (true == m_bulk)
+		{
+			ReadBoundTimeStamp(ts);
+		}
+		else if (SQL_SUCCESS != SQLGetData(m_hStmt, ++m_index_read, SQL_C_TYPE_TIMESTAMP, static_cast<SQLPOINTER>(&ts), sizeof(TIMESTAMP_STRUCT), nullptr))
 		{
 			throw StatementException(GetError());
 		}
+		else
+		{
+			m_readByteCount += sizeof(TIMESTAMP_STRUCT);
+		}
+	}
+
+	void ReadData_TimeStamp(struct tm& timeinfo)
+	{
+		TIMESTAMP_STRUCT ts = {};
+		ReadData_TimeStamp(ts);
 
 		timeinfo.tm_sec = ts.second;   // seconds after the minute - [0, 60] including leap second
 		timeinfo.tm_min = ts.minute;   // minutes after the hour - [0, 59]
@@ -504,877 +1044,6748 @@ public:
 
 	void ReadData(std::string& out_value)
 	{
-		auto columnNumber = ++m_index_read;
-		int32_t len = (GetDataSize(columnNumber) * sizeof(std::string::value_type)) + 1;
-		if (len <= 1)
+		if (true == m_bulk)
+		{
+			ReadBoundString(out_value);
 			return;
+		}
 
-		out_value.resize(len);
+		auto columnNumber = ++m_index_read;
+		int32_t size = GetDataSize(columnNumber);
 
-		SQLLEN temp = static_cast<SQLLEN>(len);
-		SQLRETURN error = SQLGetData(m_hStmt, columnNumber, SqlTypes<char>::C_TYPE, out_value.data(), out_value.length(), &temp);
-		if (!(error == SQL_SUCCESS || error == SQL_SUCCESS_WITH_INFO))
+		// (max) 컬럼은 선언 크기를 알 수 없으므로 청크 단위로 읽는다.
+		if (0 == size || static_cast<int32_t>(MAX_BOUND_COLUMN_SIZE) < size)
 		{
-			throw StatementException(GetError());
+			ReadStreamString(columnNumber, SQL_C_CHAR, out_value);
+			return;
 		}
-	}
 
-	void ReadData(std::wstring& out_value)
-	{
-		auto columnNumber = ++m_index_read;
-		int32_t len = (GetDataSize(columnNumber) * sizeof(std::wstring::value_type)) + 1;
+		int32_t len = (size * sizeof(std::string::value_type)) + 1;
 		if (len <= 1)
 			return;
 
 		out_value.resize(len);
 
 		SQLLEN temp = static_cast<SQLLEN>(len);
-		SQLRETURN error = SQLGetData(m_hStmt, columnNumber, SqlTypes<wchar_t>::C_TYPE, out_value.data(), out_value.length(), &temp);
+		SQLRETURN error = SQLGetData(m_hStmt, columnNumber, SqlTypes<char>::C_TYPE, out_value.data(), out_value.length(), &temp);
 		if (!(error == SQL_SUCCESS || error == SQL_SUCCESS_WITH_INFO))
 		{
 			throw StatementException(GetError());
 		}
+
+		FitLength(out_value, temp, true);
+
+		m_readByteCount += out_value.size();
 	}
 
-	void ReadData_Binary(std::string& out_value)
+	void ReadData(std::wstring& out_value)
 	{
+		if (true == m_bulk)
+		{
+			ReadBoundString(out_value);
+			return;
+		}
+
 		auto columnNumber = ++m_index_read;
-		int32_t len = (GetDataSize(columnNumber) * sizeof(std::wstring::value_type)) + 1;
+		int32_t size = GetDataSize(columnNumber);
+
+		if (0 == size || static_cast<int32_t>(MAX_BOUND_COLUMN_SIZE) < size)
+		{
+			ReadStreamString(columnNumber, SQL_C_WCHAR, out_value);
+			return;
+		}
+
+		int32_t len = (size * sizeof(std::wstring::value_type)) + 1;
 		if (len <= 1)
 			return;
 
 		out_value.resize(len);
 
 		SQLLEN temp = static_cast<SQLLEN>(len);
-		SQLRETURN error = SQLGetData(m_hStmt, columnNumber, SQL_C_BINARY, out_value.data(), out_value.length(), &temp);
+		SQLRETURN error = SQLGetData(m_hStmt, columnNumber, SqlTypes<wchar_t>::C_TYPE, out_value.data(), out_value.length() * sizeof(std::wstring::value_type), &temp);
 		if (!(error == SQL_SUCCESS || error == SQL_SUCCESS_WITH_INFO))
 		{
 			throw StatementException(GetError());
 		}
+
+		FitLength(out_value, temp, true);
+
+		m_readByteCount += out_value.size() * sizeof(std::wstring::value_type);
 	}
 
-	void ReadData_Binary(void* out_value, int32_t len, int32_t& out_len)
+	// 선언 크기만큼 미리 할당하지 않고 실제 데이터 크기만큼 청크 단위로 이어 붙인다.
+	void ReadData_Binary(std::string& out_value)
 	{
-		out_len = GetDataSize(++m_index_read);
-		if (out_len == 0)
+		if (true == m_bulk)
+		{
+			ReadBoundString(out_value);
 			return;
+		}
 
-		if (out_value == nullptr)
+		ReadStreamString(++m_index_read, SQL_C_BINARY, out_value);
+	}
+
+	// out_value 버퍼에 최대 len 바이트를 읽고 읽은 크기를 out_len에 기록한다.
+	void ReadData_Binary(void* out_value, int32_t len, int32_t& out_len)
+	{
+		if (true == m_bulk)
 		{
-			out_value = new char[out_len];
-			memset(out_value, 0x00, out_len);
+			out_len = ReadBoundText(static_cast<char*>(out_value), len, false);
+			return;
 		}
 
-		SQLRETURN error = SQLGetData(m_hStmt, m_index_read, SQL_C_BINARY, static_cast<SQLPOINTER>(out_value), out_len, nullptr);
+		auto columnNumber = ++m_index_read;
+		out_len = 0;
+		if (nullptr == out_value || len <= 0)
+			return;
+
+		SQLLEN indicator = 0;
+		SQLRETURN error = SQLGetData(m_hStmt, columnNumber, SQL_C_BINARY, static_cast<SQLPOINTER>(out_value), len, &indicator);
 		if (!(error == SQL_SUCCESS || error == SQL_SUCCESS_WITH_INFO))
 		{
 			throw StatementException(GetError());
 		}
+
+		if (SQL_NULL_DATA == indicator)
+			return;
+
+		// 버퍼보다 큰 데이터는 len 만큼만 읽는다.
+		out_len = (SQL_NO_TOTAL == indicator || len < indicator) ? len : static_cast<int32_t>(indicator);
+
+		m_readByteCount += static_cast<uint64_t>(out_len);
 	}
 
-	int32_t GetDataSize(int32_t col_num)
+	// LOB 컬럼을 청크 크기 단위의 SQLGetData 반복 호출로 읽어 sink(const char* data, size_t size)로 전달한다.
+	// 컬럼 크기와 관계없이 청크 버퍼 1개만 사용하며, 읽은 전체 바이트 수(NULL일 경우 SQL_NULL_DATA)를 반환한다.
+	template <typename Sink>
+	SQLLEN ReadData_Stream(Sink&& sink, SQLSMALLINT cType = SQL_C_BINARY)
 	{
-		// type = SQL_C_BINARY, SQL_C_CHAR, SQL_C_WCHAR
-		SQLCHAR colname[128];
-		SQLSMALLINT colnamelen;
-		SQLSMALLINT coltype = 0;
-		SQLULEN collen = 0;
-		SQLSMALLINT decimaldigits;
-		SQLSMALLINT nullable;
-		SQLRETURN ret = SQLDescribeCol(m_hStmt, col_num, colname, sizeof(colname), &colnamelen, &coltype, &collen, &decimaldigits, &nullable);
-		if (ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO)
+		if (true == m_bulk)
 		{
-			return static_cast<int32_t>(collen);
+			SQLLEN indicator = 0;
+			auto column = NextBoundColumn(indicator);
+			if (SQL_NULL_DATA == indicator)
+			{
+				return SQL_NULL_DATA;
+			}
+
+			SQLLEN size = (std::min)(indicator, column->width);
+			sink(column->At(m_index_row), static_cast<size_t>(size));
+			return size;
 		}
 
-		return -1;
+		return GetDataStream(++m_index_read, cType, std::forward<Sink>(sink));
 	}
 
-	_odbc_error_ptr_t GetError()
+	int32_t GetDataSize(int32_t col_num)
 	{
-		auto odbcError = std::make_shared<OdbcError>(SQL_HANDLE_STMT, m_hStmt);
-		odbcError->Parse();
+		// type = SQL_C_BINARY, SQL_C_CHAR, SQL_C_WCHAR
+		auto info = GetColumnInfo(col_num);
+		if (nullptr == info)
+		{
+			return -1;
+		}
 
-		return odbcError;
+		return static_cast<int32_t>(info->size);
 	}
 
-private:
-	SQLHSTMT m_hStmt = SQL_NULL_HSTMT;
-	eFetchResult m_fetchResult;
-	SQLUSMALLINT m_index_read = 0;
-	SQLUSMALLINT m_index_param = 0;
-	int m_index_recordset = 0;
-};
-
-class IDataAccessObject
-{
-public:
-	//    ߻    մϴ.
-	virtual void HandleOdbcException(_odbc_error_ptr_t& err) = 0;
-
-	// ڵ  ͸ б  · Ѵ.
-	virtual bool Parse(Statement* hstmt) = 0;
-
-	// ó !  ó
-	virtual void Process() = 0;
-};
-
-class IQuery
-{
-public:
-	virtual bool Build(Statement* statement) = 0;
-
-	virtual const char* GetScript() = 0;
-	virtual IDataAccessObject* GetDao() = 0;
-};
-
-// DB ó  ũƮ  Ӽ   ü
-template <typename DAO, typename... Args>
-class Query : public IQuery
-{
-public:
-	explicit Query(std::string_view str)
-		: m_dao(new DAO)
+	inline SQLSMALLINT GetColumnCount()
 	{
-		m_query = str;
-	}
-
-	~Query() = default;
+		if (false == m_described)
+		{
+			DescribeColumns();
+		}
 
-	virtual const char* GetScript() override
-	{
-		return m_query.c_str();
+		return m_columnCount;
 	}
 
-	virtual IDataAccessObject* GetDao() override
+	// col_num은 1부터 시작한다.
+	const ColumnInfo* GetColumnInfo(int32_t col_num)
 	{
-		return m_dao.get();
-	}
+		if (col_num < 1 || GetColumnCount() < col_num)
+		{
+			return nullptr;
+		}
 
-	void SetParameter(Args... args)
-	{
-		m_parameters = std::make_tuple(args...);
+		return &m_columnInfos[col_num - 1];
 	}
 
-	virtual bool Build(Statement* statement) override
+	// 이름에 해당하는 컬럼 번호를 반환한다. 없을 경우 0
+	SQLUSMALLINT FindColumn(std::string_view name)
 	{
-		if (nullptr == statement)
+		auto count = GetColumnCount();
+		for (SQLSMALLINT i = 0; i < count; ++i)
 		{
-			return false;
+			if (m_columnInfos[i].name == name)
+			{
+				return static_cast<SQLUSMALLINT>(i + 1);
+			}
 		}
 
-		m_statement = statement;
+		return 0;
+	}
 
-		MakeParameters(m_parameters, std::index_sequence_for<Args...>{});
+	_odbc_error_ptr_t GetError()
+	{
+		auto odbcError = std::make_shared<OdbcError>(SQL_HANDLE_STMT, m_hStmt);
+		odbcError->Parse();
 
-		return true;
+		return odbcError;
 	}
 
 private:
-	template <typename Tuple, std::size_t... Is>
-	void MakeParameters(const Tuple& t, std::index_sequence<Is...>)
+	// 블록 커서로 읽기 위해 바인딩된 컬럼(column-wise)
+	struct BoundColumn
 	{
-		(
-			m_statement->AddParam(std::get<Is>(t)),
-			...
-			);
-
-	}
+		SQLSMALLINT cType = SQL_C_CHAR;
+		SQLSMALLINT sqlType = 0;
+		SQLSMALLINT decimalDigits = 0;
+		SQLLEN width = 0;
+		std::vector<char> buffer;
+		std::vector<SQLLEN> indicators;
+
+		inline const char* At(SQLULEN row) { return buffer.data() + (width * row); }
+	};
 
-	Statement* m_statement;
+	// 블록 커서로 바인딩 가능한 최대 컬럼 크기. 이를 넘는 컬럼은 SQLGetData로 읽는다.
+	static constexpr SQLULEN MAX_BOUND_COLUMN_SIZE = 8000;
+	// 숫자, 날짜로 바인딩된 컬럼을 문자열로 읽을 때 사용하는 버퍼 크기
+	static constexpr size_t BOUND_TEXT_SIZE = 64;
 
-	std::string m_query;
-	std::tuple<Args...> m_parameters;
+	// 스트림 전송 및 LOB 읽기 청크 크기
+	static constexpr SQLLEN DEFAULT_STREAM_CHUNK_SIZE = 8192;
+	static constexpr SQLLEN MIN_STREAM_CHUNK_SIZE = 16;
 
-	std::unique_ptr<IDataAccessObject> m_dao;
-};
+	// SQL_STILL_EXECUTING 재호출 시 양보만 하는 횟수
+	static constexpr int32_t STILL_EXECUTING_YIELD_COUNT = 16;
 
-// DB  ü
-class Odbc
-{
-public:
-	enum class eState
+	// SQL_NEED_DATA 상태에서 요청된 스트림 파라미터를 순서대로 청크 단위로 전송한다.
+	// 마지막 SQLParamData의 결과가 실행 결과가 된다.
+	SQLRETURN PutStreams()
 	{
-		None = 0,
-		Free,
-		Used
-	};
+		m_needData = true;
+		m_streamBuffer.resize(m_streamChunkSize);
 
-	Odbc()
-		: m_hDbc(SQL_NULL_HDBC)
-		, m_hEnv(SQL_NULL_HENV)
-		, m_query(nullptr)
-		, m_state(eState::None)
-	{
-	}
+		SQLPOINTER token = nullptr;
+		SQLRETURN retcode = ParamData(token);
+		while (SQL_NEED_DATA == retcode)
+		{
+			auto stream = static_cast<IParamStream*>(token);
+			if (nullptr == stream || false == stream->Rewind())
+			{
+				return SQL_ERROR;
+			}
 
-	~Odbc()
-	{
-		CleanUp();
+			for (;;)
+			{
+				SQLLEN size = stream->Read(m_streamBuffer.data(), m_streamChunkSize);
+				if (size < 0)
+				{
+					return SQL_ERROR;
+				}
+
+				if (0 == size)
+				{
+					break;
+				}
+
+				// 비동기 모드에서는 완료될 때까지 다시 호출한다.
+				retcode = SQLPutData(m_hStmt, m_streamBuffer.data(), size);
+				for (int32_t waitCount = 0; SQL_STILL_EXECUTING == retcode; )
+				{
+					WaitStillExecuting(waitCount);
+					retcode = SQLPutData(m_hStmt, m_streamBuffer.data(), size);
+				}
+
+				if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+				{
+					return retcode;
+				}
+			}
+
+			retcode = ParamData(token);
+		}
+
+		m_needData = false;
+		return retcode;
 	}
 
-	inline void SetState(eState state) { m_state = state; }
-	inline bool IsFree() { return (m_state == eState::Free); }
-	inline bool IsUsed() { return (m_state == eState::Used); }
-	inline bool IsActive() { return (m_state != eState::None); }
-	
-	bool SetFreeState() 
+	// 비동기 모드에서는 완료될 때까지 다시 호출한다.
+	SQLRETURN ParamData(SQLPOINTER& out_token)
 	{
-		eState state = eState::Used;
-		return m_state.compare_exchange_strong(state, eState::Free);
+		SQLRETURN retcode = SQLParamData(m_hStmt, &out_token);
+		for (int32_t waitCount = 0; SQL_STILL_EXECUTING == retcode; )
+		{
+			WaitStillExecuting(waitCount);
+			retcode = SQLParamData(m_hStmt, &out_token);
+		}
+
+		return retcode;
 	}
 
-	bool Setup(const char* connectionString, _logging_ptr_t& logging)
+	template <typename Sink>
+	SQLLEN GetDataStream(SQLUSMALLINT columnNumber, SQLSMALLINT cType, Sink&& sink)
 	{
-		
-		m_hEnv = AllocENV();
-		if (m_hEnv == nullptr)
+		m_streamBuffer.resize(m_streamChunkSize);
+
+		// 문자열은 청크마다 종료 문자가 포함된다.
+		SQLLEN terminator = 0;
+		if (SQL_C_CHAR == cType)
 		{
-			return false;
+			terminator = sizeof(SQLCHAR);
+		}
+		else if (SQL_C_WCHAR == cType)
+		{
+			terminator = sizeof(SQLWCHAR);
 		}
 
-		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Allocate an environment.");
+		SQLLEN capacity = m_streamChunkSize - terminator;
+		if (SQL_C_WCHAR == cType)
+		{
+			capacity -= capacity % sizeof(SQLWCHAR);
+		}
 
-		m_hDbc = AllocDBC(m_hEnv, connectionString);
-		if (m_hDbc == nullptr)
+		SQLLEN total = 0;
+		for (;;)
 		{
-			if (m_hEnv != nullptr)
+			SQLLEN indicator = 0;
+			SQLRETURN retcode = SQLGetData(m_hStmt, columnNumber, cType, m_streamBuffer.data(), m_streamChunkSize, &indicator);
+			if (SQL_NO_DATA == retcode)
 			{
-				SQLFreeHandle(SQL_HANDLE_STMT, m_hEnv);
-				m_hEnv = nullptr;
+				break;
 			}
 
-			return false;
-		}
-
-		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Allocate an DBC.");
+			if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+			{
+				throw StatementException(GetError());
+			}
 
-		m_logging = logging;
-		
-		m_statement.Open(AllocSTMT(m_hDbc));
+			if (SQL_NULL_DATA == indicator)
+			{
+				return SQL_NULL_DATA;
+			}
 
-		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Allocate an statement.");
+			// 남은 데이터가 청크보다 크면(01004) 버퍼가 가득 채워진다.
+			SQLLEN size = (SQL_NO_TOTAL == indicator || capacity < indicator) ? capacity : indicator;
+			if (0 < size)
+			{
+				sink(static_cast<const char*>(m_streamBuffer.data()), static_cast<size_t>(size));
+				total += size;
+			}
 
-		if (false == m_statement.IsOpen())
-		{
-			return false;
+			if (SQL_SUCCESS == retcode)
+			{
+				break;
+			}
 		}
 
-		return true;
+		m_readByteCount += static_cast<uint64_t>(total);
+
+		return total;
 	}
 
-	void CleanUp()
+	template <typename CharT>
+	void ReadStreamString(SQLUSMALLINT columnNumber, SQLSMALLINT cType, std::basic_string<CharT>& out_value)
 	{
-		// Ȱȭ 
-		SetState(eState::None);
+		out_value.clear();
 
-		if (true == m_statement.IsOpen())
+		// wchar_t 경계에 걸친 청크를 위해 바이트 단위로 이어 붙인 후 변환한다.
+		if constexpr (1 < sizeof(CharT))
+		{
+			std::string bytes;
+			GetDataStream(columnNumber, cType, [&bytes](const char* data, size_t size) { bytes.append(data, size); });
+			out_value.resize(bytes.size() / sizeof(CharT));
+			memcpy(out_value.data(), bytes.data(), out_value.size() * sizeof(CharT));
+		}
+		else
 		{
-			m_statement.Destroy();
+			GetDataStream(columnNumber, cType, [&out_value](const char* data, size_t size) { out_value.append(reinterpret_cast<const CharT*>(data), size); });
 		}
+	}
 
-		if (m_hDbc != nullptr)
+	// SQLGetData가 반환한 길이에 맞게 문자열 크기를 줄인다.
+	// text는 버퍼 마지막에 종료 문자가 포함된다.
+	template <typename CharT>
+	static void FitLength(std::basic_string<CharT>& value, SQLLEN indicator, bool text)
+	{
+		if (SQL_NULL_DATA == indicator)
 		{
-			SQLDisconnect(m_hDbc);
-			SQLFreeHandle(SQL_HANDLE_DBC, m_hDbc);
-			m_hDbc = SQL_NULL_HANDLE;
+			value.clear();
+			return;
 		}
 
-		if (m_hEnv != nullptr)
+		size_t capacity = (true == text && false == value.empty()) ? value.size() - 1 : value.size();
+		if (SQL_NO_TOTAL == indicator)
 		{
-			SQLFreeHandle(SQL_HANDLE_ENV, m_hEnv);
-			m_hEnv = SQL_NULL_HANDLE;
+			value.resize(capacity);
+			return;
 		}
 
-		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Completed.");
+		value.resize((std::min)(capacity, static_cast<size_t>(indicator) / sizeof(CharT)));
 	}
 
-	inline Statement& GetStatement()
+	// 레코드셋의 컬럼 수 및 컬럼 정보를 조회하여 보관한다.
+	void DescribeColumns()
 	{
-		return m_statement;
-	}
+		m_described = true;
+		m_columnCount = 0;
 
-	bool BindQuery(IQuery* query)
-	{
-		m_query = query;
+		SQLSMALLINT columnCount = 0;
+		SQLRETURN ret = SQLNumResultCols(m_hStmt, &columnCount);
+		if (!(ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO) || columnCount <= 0)
+		{
+			return;
+		}
 
-		// ε մϴ.
-		m_query->Build(&GetStatement());
+		if (m_columnInfos.size() < static_cast<size_t>(columnCount))
+		{
+			m_columnInfos.resize(columnCount);
+		}
 
-		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, m_query->GetScript());
-		
-		return true;
+		for (SQLSMALLINT i = 0; i < columnCount; ++i)
+		{
+			auto& info = m_columnInfos[i];
+
+			SQLCHAR colname[128];
+			SQLSMALLINT colnamelen = 0;
+			ret = SQLDescribeCol(m_hStmt, i + 1, colname, sizeof(colname), &colnamelen, &info.type, &info.size, &info.decimalDigits, &info.nullable);
+			if (!(ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO))
+			{
+				info = ColumnInfo{};
+				continue;
+			}
+
+			info.name.assign(reinterpret_cast<const char*>(colname), (std::min)(static_cast<size_t>(colnamelen), sizeof(colname) - 1));
+		}
+
+		m_columnCount = columnCount;
 	}
 
-	SQLRETURN Execute()
+	bool BindColumns()
 	{
-		auto sqlResultCode = GetStatement().Prepare(m_query->GetScript());
-		if (SQL_SUCCESS != sqlResultCode)
+		auto columnCount = m_columnCount;
+		if (m_columns.size() < static_cast<size_t>(columnCount))
 		{
-			auto errorObject = GetStatement().GetError();
-			m_query->GetDao()->HandleOdbcException(errorObject);
-
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
-
-			return sqlResultCode;
+			m_columns.resize(columnCount);
 		}
 
-		sqlResultCode = GetStatement().Execute();
-		if (SQL_SUCCESS != sqlResultCode)
+		for (SQLSMALLINT i = 0; i < columnCount; ++i)
 		{
-			// Ǯ ȯ ʵ óǾϸ   Ȳ Ǿ Ѵ.
-			auto errorObject = GetStatement().GetError();
-			m_query->GetDao()->HandleOdbcException(errorObject);
+			auto coltype = m_columnInfos[i].type;
+			auto collen = m_columnInfos[i].size;
 
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
+			auto& column = m_columns[i];
+			column.sqlType = coltype;
+			column.decimalDigits = m_columnInfos[i].decimalDigits;
+			switch (coltype)
+			{
+			case SQL_BIT:
+			case SQL_TINYINT:
+			case SQL_SMALLINT:
+			case SQL_INTEGER:
+			case SQL_BIGINT:
+				column.cType = SQL_C_SBIGINT;
+				column.width = sizeof(int64_t);
+				break;
+			case SQL_REAL:
+			case SQL_FLOAT:
+			case SQL_DOUBLE:
+				column.cType = SQL_C_DOUBLE;
+				column.width = sizeof(double);
+				break;
+			case SQL_DATETIME:
+			case SQL_TYPE_DATE:
+			case SQL_TYPE_TIMESTAMP:
+				column.cType = SQL_C_TYPE_TIMESTAMP;
+				column.width = sizeof(TIMESTAMP_STRUCT);
+				break;
+			case SQL_CHAR:
+			case SQL_VARCHAR:
+			case SQL_DECIMAL:
+			case SQL_NUMERIC:
+				if (0 == collen || MAX_BOUND_COLUMN_SIZE < collen)
+				{
+					return false;
+				}
+				column.cType = SQL_C_CHAR;
+				// 부호, 소수점 포함
+				column.width = static_cast<SQLLEN>(collen) + 3;
+				break;
+			case SQL_WCHAR:
+			case SQL_WVARCHAR:
+				if (0 == collen || MAX_BOUND_COLUMN_SIZE < collen)
+				{
+					return false;
+				}
+				column.cType = SQL_C_WCHAR;
+				column.width = static_cast<SQLLEN>((collen + 1) * sizeof(SQLWCHAR));
+				break;
+			case SQL_BINARY:
+			case SQL_VARBINARY:
+				if (0 == collen || MAX_BOUND_COLUMN_SIZE < collen)
+				{
+					return false;
+				}
+				column.cType = SQL_C_BINARY;
+				column.width = static_cast<SQLLEN>(collen);
+				break;
+			default:
+				// LOB, GUID 등은 row 단위로 읽는다.
+				return false;
+			}
 
-			return sqlResultCode;
+			column.buffer.resize(column.width * m_rowArraySize);
+			column.indicators.resize(m_rowArraySize);
 		}
 
-		sqlResultCode = GetStatement().Fetch();
-		if (SQL_SUCCESS != sqlResultCode)
+		m_rowStatus.resize(m_rowArraySize);
+
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_BIND_TYPE, reinterpret_cast<SQLPOINTER>(SQL_BIND_BY_COLUMN), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(m_rowArraySize), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_STATUS_PTR, m_rowStatus.data(), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROWS_FETCHED_PTR, &m_rowsFetched, 0);
+
+		m_bulk = true;
+		m_boundColumnCount = columnCount;
+
+		for (SQLSMALLINT i = 0; i < columnCount; ++i)
 		{
-			// Ǯ ȯ ʵ óǾϸ   Ȳ Ǿ Ѵ.
-			if (SQL_NO_DATA != sqlResultCode)
+			auto& column = m_columns[i];
+			SQLRETURN ret = SQLBindCol(m_hStmt, i + 1, column.cType, column.buffer.data(), column.width, column.indicators.data());
+			if (!(ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO))
 			{
-				auto errorObject = GetStatement().GetError();
-				m_query->GetDao()->HandleOdbcException(errorObject);
-
-				OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
+				UnbindColumns();
+				return false;
 			}
-			return sqlResultCode;
 		}
 
-		try
+		return true;
+	}
+
+	void UnbindColumns()
+	{
+		if (false == m_bulk && false == m_rowWise)
 		{
-			do
-			{
-				if (true == GetStatement().IsNoData())
-				{
-					// ش ڵ¿ Ͱ    ڵ ̵մϴ.
-					continue;
-				}
+			return;
+		}
 
-				if (false == m_query->GetDao()->Parse(&GetStatement()))
-				{
-					// Todo: ܹ߻Ͽ  ó ʿϴ.
-					//   ƴ  ̱  break  SQL_SUCCESS ȯѴ.
-					break;
-				}
-			} while (true == GetStatement().MoveNextRecordSet());
+		SQLFreeStmt(m_hStmt, SQL_UNBIND);
+		if (true == m_rowWise)
+		{
+			SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_BIND_TYPE, reinterpret_cast<SQLPOINTER>(SQL_BIND_BY_COLUMN), 0);
+		}
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(1), 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROW_STATUS_PTR, nullptr, 0);
+		SQLSetStmtAttr(m_hStmt, SQL_ATTR_ROWS_FETCHED_PTR, nullptr, 0);
+
+		m_bulk = false;
+		m_rowWise = false;
+		m_boundColumnCount = 0;
+		m_rowsFetched = 0;
+		m_index_row = 0;
+	}
 
-			// ڵ Ľ    ó Ҽ ֵ Result ޼带 ȣ Ѵ.
-			m_query->GetDao()->Process();
+	SQLRETURN FetchBlock()
+	{
+		m_rowsFetched = 0;
+		m_index_row = 0;
 
+		SQLRETURN retcode = SQLFetch(m_hStmt);
+		if (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO)
+		{
+			return SeekBoundRow();
 		}
-		catch (StatementException& e)
+
+		if (SQL_NO_DATA == retcode)
 		{
-			// ũƼ   ȯѴ.
-			if (true == e.GetNative()->IsCritical())
+			m_index_read = 0;
+			m_fetchResult = eFetchResult::EMPTY;
+		}
+
+		return retcode;
+	}
+
+	// 행 상태 배열을 확인하여 읽을 수 있는 row로 이동한다.
+	SQLRETURN SeekBoundRow()
+	{
+		for (; m_index_row < m_rowsFetched; ++m_index_row)
+		{
+			auto status = m_rowStatus[m_index_row];
+			if (SQL_ROW_NOROW == status)
+			{
+				continue;
+			}
+
+			if (SQL_ROW_ERROR == status)
 			{
+				m_fetchResult = eFetchResult::ERR;
 				return SQL_ERROR;
 			}
 
-			m_query->GetDao()->HandleOdbcException(e.GetNative());
+			m_index_read = 0;
+			m_fetchResult = eFetchResult::OK;
+			++m_readRowCount;
+			return SQL_SUCCESS;
+		}
 
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, e.GetNative()->ToString());
+		// 블록의 모든 row가 비어있을 경우 다음 블록을 읽는다.
+		return FetchBlock();
+	}
+
+	// 바인딩 범위를 벗어난 컬럼은 nullptr을 반환한다.
+	BoundColumn* NextBoundColumn(SQLLEN& out_indicator)
+	{
+		auto columnNumber = ++m_index_read;
+		if (columnNumber < 1 || m_boundColumnCount < columnNumber)
+		{
+			// 드라이버 호출로 동일한 에러(07009)를 발생시킨다.
+			SQLGetData(m_hStmt, columnNumber, SQL_C_DEFAULT, nullptr, 0, nullptr);
+			throw StatementException(GetError());
 		}
 
-		GetStatement().Close();
+		auto& column = m_columns[columnNumber - 1];
+		out_indicator = column.indicators[m_index_row];
 
-		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Completed.");
+		AddReadBytes(out_indicator, column.width);
 
-		return SQL_SUCCESS;
+		return &column;
 	}
 
-	_odbc_error_ptr_t GetDbcError()
+	// 드라이버가 반환한 길이(indicator)로 읽은 크기를 누적한다. 버퍼보다 크면 버퍼 크기만큼 읽은 것으로 본다.
+	inline void AddReadBytes(SQLLEN indicator, SQLLEN capacity)
 	{
-		auto odbcError = std::make_shared<OdbcError>(SQL_HANDLE_DBC, m_hDbc);
-		odbcError->Parse();
+		if (SQL_NULL_DATA == indicator)
+		{
+			return;
+		}
 
-		return odbcError;
+		m_readByteCount += static_cast<uint64_t>((SQL_NO_TOTAL == indicator || capacity < indicator) ? capacity : indicator);
 	}
 
-private:
-	SQLHENV AllocENV()
+	template <typename T>
+	void ReadBoundData(T& value)
 	{
-		// ms. https://docs.microsoft.com/ko-kr/sql/odbc/microsoft-open-database-connectivity-odbc?view=sql-server-2017
-		// ibm. https://www.ibm.com/support/knowledgecenter/ko/SSEPGG_10.5.0/com.ibm.db2.luw.apdv.cli.doc/doc/r0000553.html
-
-		SQLHENV hEnv;
-		SQLRETURN retcode = SQL_ERROR;
-
-		// Allocate an environment.
-		retcode = SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &hEnv);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		SQLLEN indicator = 0;
+		auto column = NextBoundColumn(indicator);
+		if (SQL_NULL_DATA == indicator)
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to allocate an environment.");
-			return nullptr;
+			value = T{};
+			return;
 		}
 
-		// https://www.ibm.com/support/knowledgecenter/ko/SSEPGG_10.5.0/com.ibm.db2.luw.apdv.cli.doc/doc/r0006817.html
-
-		// Register this as an application that expects 3.x behavior, you must register something if you use AllocHandle.
-		retcode = SQLSetEnvAttr(hEnv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, SQL_IS_INTEGER);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		const char* data = column->At(m_index_row);
+		if constexpr (std::is_arithmetic_v<T>)
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to register an attribute that is SQL_ATTR_ODBC_VERSION.");
-			SQLFreeHandle(SQL_HANDLE_STMT, hEnv);
-			return nullptr;
+			switch (column->cType)
+			{
+			case SQL_C_SBIGINT:
+			{
+				int64_t temp;
+				memcpy(&temp, data, sizeof(temp));
+				value = static_cast<T>(temp);
+				return;
+			}
+			case SQL_C_DOUBLE:
+			{
+				double temp;
+				memcpy(&temp, data, sizeof(temp));
+				value = static_cast<T>(temp);
+				return;
+			}
+			case SQL_C_CHAR:
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					value = static_cast<T>(strtod(data, nullptr));
+				}
+				else
+				{
+					value = static_cast<T>(strtoll(data, nullptr, 10));
+				}
+				return;
+			default:
+				break;
+			}
 		}
 
-		return hEnv;
+		memset(&value, 0x00, sizeof(T));
+		memcpy(&value, data, (std::min)(static_cast<size_t>(indicator), sizeof(T)));
 	}
 
-	SQLHDBC AllocDBC(SQLHENV hEnv, const char* connection_string)
+	template <typename CharT>
+	int32_t ReadBoundText(CharT* out_value, int32_t len, bool terminate = true)
 	{
-		SQLHDBC hDbc = nullptr;
-		SQLRETURN retcode = SQL_ERROR;
-
-		// Allocate a connection.
-		retcode = SQLAllocHandle(SQL_HANDLE_DBC, hEnv, &hDbc);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		SQLLEN indicator = 0;
+		auto column = NextBoundColumn(indicator);
+		if (nullptr == out_value || len <= 0)
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to allocate a DBC.");
-			return nullptr;
+			return 0;
 		}
 
-		// connection attribute setting.
-		retcode = SQLSetConnectAttr(hDbc, SQL_LOGIN_TIMEOUT, reinterpret_cast<SQLPOINTER>(1), 0);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		// 숫자, 날짜 컬럼은 문자열로 변환하여 복사한다.
+		char text[BOUND_TEXT_SIZE];
+		size_t textLength = 0;
+		if (true == terminate && SQL_NULL_DATA != indicator && true == FormatBoundValue(*column, column->At(m_index_row), text, textLength))
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_LOGIN_TIMEOUT.");
-			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
-			return nullptr;
-		}
+			size_t count = (std::min)(textLength, static_cast<size_t>(len) / sizeof(CharT) - 1);
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_value[i] = static_cast<CharT>(text[i]);
+			}
+			out_value[count] = 0;
 
-		retcode = SQLSetConnectAttr(hDbc, SQL_ATTR_CONNECTION_TIMEOUT, reinterpret_cast<SQLPOINTER>(1), 0);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
-		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_ATTR_CONNECTION_TIMEOUT.");
-			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
-			return nullptr;
+			return static_cast<int32_t>(count * sizeof(CharT));
 		}
 
-		retcode = SQLSetConnectAttr(hDbc, SQL_ATTR_AUTOCOMMIT, reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_ON), SQL_IS_UINTEGER);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		// len은 바이트 단위 버퍼 크기
+		int32_t size = (SQL_NULL_DATA == indicator) ? 0 : static_cast<int32_t>((std::min)(indicator, column->width));
+		if (true == terminate)
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_ATTR_AUTOCOMMIT.");
-
-			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
-			return nullptr;
+			size = (std::max)(0, (std::min)(size, len - static_cast<int32_t>(sizeof(CharT))));
+			size -= size % static_cast<int32_t>(sizeof(CharT));
 		}
-#ifdef SQL_COPT_SS_MARS_ENABLED
-		retcode = SQLSetConnectAttr(hDbc, SQL_COPT_SS_MARS_ENABLED, reinterpret_cast<SQLPOINTER>(SQL_MARS_ENABLED_YES), SQL_IS_UINTEGER);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		else
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_COPT_SS_MARS_ENABLED.");
-
-			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
-			return nullptr;
+			size = (std::min)(size, len);
 		}
-#endif
 
-		SQLCHAR* ODBC_ConnectionString = (SQLCHAR*)connection_string;
-		SQLCHAR         buffer[1024] = { 0x00, };
-		SQLSMALLINT     outlen = 0;
-
-		// https://docs.microsoft.com/ko-kr/sql/odbc/reference/syntax/sqldriverconnect-function?view=sql-server-ver15
-		// Connect to the driver.  Use the connection string if supplied on the input, otherwise let the driver manager prompt for input.
-		retcode = SQLDriverConnect(hDbc, nullptr, ODBC_ConnectionString, SQL_NTS, buffer, static_cast<SQLSMALLINT>(255), &outlen, SQL_DRIVER_NOPROMPT);
-		if (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO)
+		memcpy(out_value, column->At(m_index_row), size);
+		if (true == terminate)
 		{
-			return hDbc;
+			out_value[size / sizeof(CharT)] = 0;
 		}
 
-		// 		int32_t retry_count = RETRY_COUNT;
-		// 		retcode = SQLGetConnectAttr(hDbc, SQL_COPT_SS_CONNECT_RETRY_COUNT, &retry_count, SQL_IS_INTEGER, NULL);
-		// 		retcode = SQLGetConnectAttr(hDbc, SQL_COPT_SS_CONNECT_RETRY_INTERVAL, &retry_count, SQL_IS_INTEGER, NULL);
-
-		auto dbcError = GetDbcError();
-		OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, dbcError->ToString());
-
-		SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
-		return nullptr;
+		return size;
 	}
 
-	SQLHSTMT AllocSTMT(SQLHDBC hDbc)
+	template <typename CharT>
+	void ReadBoundString(std::basic_string<CharT>& out_value)
 	{
-		SQLHSTMT hStmt;
-		SQLRETURN retcode = SQL_ERROR;
+		SQLLEN indicator = 0;
+		auto column = NextBoundColumn(indicator);
+		if (SQL_NULL_DATA == indicator)
+		{
+			out_value.clear();
+			return;
+		}
 
-		// Allocate a Statement.
-		retcode = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
-		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		const char* data = column->At(m_index_row);
+
+		char text[BOUND_TEXT_SIZE];
+		size_t textLength = 0;
+		if (true == FormatBoundValue(*column, data, text, textLength))
 		{
-			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to allocate a handle that is SQL_HANDLE_STMT.");
-			return nullptr;
+			out_value.assign(text, text + textLength);
+			return;
 		}
 
-		return hStmt;
+		auto size = static_cast<size_t>((std::min)(indicator, column->width));
+		switch (column->cType)
+		{
+		case SQL_C_CHAR:
+			out_value.assign(data, data + size);
+			break;
+		case SQL_C_WCHAR:
+		{
+			auto begin = reinterpret_cast<const SQLWCHAR*>(data);
+			out_value.assign(begin, begin + (size / sizeof(SQLWCHAR)));
+			break;
+		}
+		default:
+			out_value.resize(size / sizeof(CharT));
+			memcpy(out_value.data(), data, out_value.size() * sizeof(CharT));
+			break;
+		}
 	}
 
-	template <ILogging::eLevel level, typename... Args>
-	void OnLog(const char* function, int32_t line, std::string_view format, Args... args)
+	void ReadBoundTimeStamp(TIMESTAMP_STRUCT& ts)
 	{
-		if (nullptr == m_logging)
+		SQLLEN indicator = 0;
+		auto column = NextBoundColumn(indicator);
+		if (SQL_NULL_DATA == indicator)
 		{
+			ts = TIMESTAMP_STRUCT{};
 			return;
 		}
 
-		std::stringstream ss;
-		ss << "[" << NamedLoggingLevel<level>::Name() << "][" << function << "(" << line << ")][" << format << "]";
-		
-		std::string message = ss.str();
+		if (SQL_C_TYPE_TIMESTAMP != column->cType)
+		{
+			// row 단위 읽기와 같이 변환할 수 없는 컬럼은 드라이버 에러(07006)로 처리한다.
+			SQLGetData(m_hStmt, m_index_read, SQL_C_TYPE_TIMESTAMP, nullptr, 0, nullptr);
+			throw StatementException(GetError());
+		}
 
-		switch (level)
+		memcpy(&ts, column->At(m_index_row), sizeof(TIMESTAMP_STRUCT));
+	}
+
+	// 숫자, 날짜로 바인딩된 컬럼을 row 단위 SQL_C_CHAR 읽기와 같은 형식의 문자열로 변환한다.
+	// 문자열, 바이너리 컬럼은 변환하지 않고 false를 반환한다.
+	static bool FormatBoundValue(const BoundColumn& column, const char* data, char (&out_text)[BOUND_TEXT_SIZE], size_t& out_length)
+	{
+		std::to_chars_result result = {};
+		switch (column.cType)
 		{
-		case ILogging::eLevel::Trace:
-			m_logging->Trace(message);
-			break;
-		case ILogging::eLevel::Debug:
-			m_logging->Debug(message);
-			break;
-		case ILogging::eLevel::Info:
-			m_logging->Info(message);
-			break;
-		case ILogging::eLevel::Warning:
-			m_logging->Warning(message);
+		case SQL_C_SBIGINT:
+		{
+			int64_t temp;
+			memcpy(&temp, data, sizeof(temp));
+			result = std::to_chars(out_text, out_text + BOUND_TEXT_SIZE, temp);
 			break;
-		case ILogging::eLevel::Error:
-			m_logging->Error(message);
+		}
+		case SQL_C_DOUBLE:
+		{
+			// 다시 읽었을 때 같은 값이 되는 가장 짧은 표현
+			double temp;
+			memcpy(&temp, data, sizeof(temp));
+			result = std::to_chars(out_text, out_text + BOUND_TEXT_SIZE, temp);
 			break;
+		}
+		case SQL_C_TYPE_TIMESTAMP:
+			out_length = FormatTimeStamp(column, data, out_text);
+			return true;
 		default:
-			break;
+			return false;
 		}
+
+		out_length = (std::errc() == result.ec) ? static_cast<size_t>(result.ptr - out_text) : 0;
+		return true;
 	}
 
-	std::atomic<eState> m_state = eState::None;
+	// yyyy-mm-dd (DATE), yyyy-mm-dd hh:mm:ss[.f...] (소수 자릿수는 컬럼 정의를 따른다.)
+	static size_t FormatTimeStamp(const BoundColumn& column, const char* data, char (&out_text)[BOUND_TEXT_SIZE])
+	{
+		TIMESTAMP_STRUCT ts;
+		memcpy(&ts, data, sizeof(ts));
 
-	SQLHENV m_hEnv = SQL_NULL_HENV;
-	SQLHDBC m_hDbc = SQL_NULL_HDBC;
-	Statement m_statement;
+		int length = 0;
+		if (SQL_TYPE_DATE == column.sqlType)
+		{
+			length = snprintf(out_text, BOUND_TEXT_SIZE, "%04d-%02u-%02u", ts.year, ts.month, ts.day);
+		}
+		else
+		{
+			length = snprintf(out_text, BOUND_TEXT_SIZE, "%04d-%02u-%02u %02u:%02u:%02u", ts.year, ts.month, ts.day, ts.hour, ts.minute, ts.second);
 
-	IQuery* m_query = nullptr;
-	_logging_ptr_t m_logging;
+			// fraction은 나노초 단위
+			int32_t digits = (std::min)(static_cast<int32_t>(column.decimalDigits), 9);
+			if (0 < digits && 0 < length)
+			{
+				SQLUINTEGER fraction = ts.fraction;
+				for (int32_t i = digits; i < 9; ++i)
+				{
+					fraction /= 10;
+				}
+
+				length += snprintf(out_text + length, BOUND_TEXT_SIZE - length, ".%0*u", digits, static_cast<unsigned int>(fraction));
+			}
+		}
+
+		return (0 < length) ? (std::min)(static_cast<size_t>(length), BOUND_TEXT_SIZE - 1) : 0;
+	}
+
+	SQLHSTMT m_hStmt = SQL_NULL_HSTMT;
+	bool m_prepared = false;
+	bool m_async = false;
+	std::pmr::memory_resource* m_memoryResource = nullptr;
+	SQLULEN m_paramSetSize = 1;
+
+	// data-at-execution 파라미터 및 LOB 청크 버퍼
+	bool m_needData = false;
+	SQLLEN m_streamChunkSize = DEFAULT_STREAM_CHUNK_SIZE;
+	std::vector<char> m_streamBuffer;
+	std::list<SQLLEN> m_streamIndicators;
+	eFetchResult m_fetchResult;
+	SQLUSMALLINT m_index_read = 0;
+	SQLUSMALLINT m_index_param = 0;
+	int m_index_recordset = 0;
+
+	// 블록 커서(bulk fetch)
+	bool m_bulk = false;
+	bool m_rowWise = false;
+	SQLULEN m_rowArraySize = 1;
+	SQLULEN m_rowsFetched = 0;
+	SQLULEN m_index_row = 0;
+	SQLUSMALLINT m_boundColumnCount = 0;
+	std::vector<SQLUSMALLINT> m_rowStatus;
+	std::vector<BoundColumn> m_columns;
+
+	// 현재 레코드셋의 컬럼 정보
+	bool m_described = false;
+	SQLSMALLINT m_columnCount = 0;
+	std::vector<ColumnInfo> m_columnInfos;
+
+	// 읽은 row 수와 컬럼 데이터 크기 (모니터링)
+	uint64_t m_readRowCount = 0;
+	uint64_t m_readByteCount = 0;
 };
 
-//  ̽
-template <typename Element>
-class IQueue
+// RowSchema 컬럼 타입별 바인딩 정보
+// 기본은 SqlTypes에 정의된 산술 타입
+template <typename T, size_t StringCapacity>
+struct RowColumn
 {
-public:
-	using _element_t = Element;
+	static_assert(std::is_arithmetic_v<T>, "A RowSchema column must be an arithmetic, string or TIMESTAMP_STRUCT type.");
 
-	virtual bool TryPop(_element_t& task) = 0;
-	virtual void Put(_element_t&& task) = 0;
+	using _storage_t = T;
+	static constexpr SQLSMALLINT C_TYPE = SqlTypes<T>::C_TYPE;
+
+	static inline void Read(Statement* statement, T& out_value) { statement->ReadData(out_value); }
+
+	static inline bool Assign(T& out_value, const _storage_t& value, SQLLEN indicator)
+	{
+		out_value = (SQL_NULL_DATA == indicator) ? T{} : value;
+		return true;
+	}
+};
+
+template <typename CharT, size_t StringCapacity>
+struct RowColumn<std::basic_string<CharT>, StringCapacity>
+{
+	using _storage_t = CharT[StringCapacity + 1];
+	static constexpr SQLSMALLINT C_TYPE = SqlTypes<CharT>::C_TYPE;
+
+	static inline void Read(Statement* statement, std::basic_string<CharT>& out_value) { statement->ReadData(out_value); }
+
+	// 버퍼보다 긴 값은 잘리므로 실패 처리한다.
+	static inline bool Assign(std::basic_string<CharT>& out_value, const _storage_t& value, SQLLEN indicator)
+	{
+		if (SQL_NULL_DATA == indicator)
+		{
+			out_value.clear();
+			return true;
+		}
+
+		if (SQL_NO_TOTAL == indicator || static_cast<SQLLEN>(StringCapacity * sizeof(CharT)) < indicator)
+		{
+			return false;
+		}
+
+		out_value.assign(value, indicator / sizeof(CharT));
+		return true;
+	}
+};
+
+template <size_t StringCapacity>
+struct RowColumn<TIMESTAMP_STRUCT, StringCapacity>
+{
+	using _storage_t = TIMESTAMP_STRUCT;
+	static constexpr SQLSMALLINT C_TYPE = SQL_C_TYPE_TIMESTAMP;
+
+	static inline void Read(Statement* statement, TIMESTAMP_STRUCT& out_value) { statement->ReadData_TimeStamp(out_value); }
+
+	static inline bool Assign(TIMESTAMP_STRUCT& out_value, const _storage_t& value, SQLLEN indicator)
+	{
+		out_value = (SQL_NULL_DATA == indicator) ? TIMESTAMP_STRUCT{} : value;
+		return true;
+	}
+};
+
+// DAO row 구조체의 멤버 포인터 목록으로 row-wise 바인딩을 생성한다.
+// 컬럼 타입, 크기, C 타입은 컴파일 타임에 결정되며 SQL_ATTR_ROW_BIND_TYPE = sizeof(row)로 블록 단위로 읽는다.
+// std::string 멤버는 직접 바인딩할 수 없으므로 StringCapacity 크기의 고정 버퍼 row에 읽은 후 옮긴다.
+// ex) RowSchema<&element::type, &element::info, &element::expiretime>::Read(statement, results);
+template <size_t StringCapacity, auto... Members>
+class BasicRowSchema
+{
+	static_assert(0 < sizeof...(Members), "A RowSchema needs at least one column.");
+
+	template <typename>
+	struct MemberOf;
+
+	template <typename C, typename T>
+	struct MemberOf<T C::*>
+	{
+		using _class_t = C;
+		using _value_t = T;
+	};
+
+	template <auto Member>
+	using _column_t = RowColumn<typename MemberOf<decltype(Member)>::_value_t, StringCapacity>;
+
+	template <typename Column>
+	struct Cell
+	{
+		typename Column::_storage_t value;
+		SQLLEN indicator;
+	};
+
+public:
+	using _row_t = typename MemberOf<std::tuple_element_t<0, std::tuple<decltype(Members)...>>>::_class_t;
+	using _staging_t = std::tuple<Cell<_column_t<Members>>...>;
+
+	static_assert((std::is_same_v<_row_t, typename MemberOf<decltype(Members)>::_class_t> && ...), "All RowSchema columns must be members of the same row type.");
+
+	static constexpr SQLUSMALLINT COLUMN_COUNT = static_cast<SQLUSMALLINT>(sizeof...(Members));
+	static constexpr SQLULEN DEFAULT_ROW_ARRAY_SIZE = 128;
+
+	// 현재 레코드셋의 남은 row를 모두 읽어 rows 뒤에 추가한다.
+	// 이미 읽은 row(현재 위치 및 블록에 남은 row)는 ReadData로, 이후 row는 row-wise 블록으로 읽는다.
+	// rows는 _row_t를 보관하는 std::vector 또는 std::pmr::vector
+	template <typename Container>
+	static void Read(Statement* statement, Container& rows, SQLULEN rowArraySize = DEFAULT_ROW_ARRAY_SIZE)
+	{
+		static_assert(std::is_same_v<typename Container::value_type, _row_t>, "A container must hold the RowSchema row type.");
+
+		if (true == statement->IsNoData())
+		{
+			return;
+		}
+
+		do
+		{
+			ReadCurrent(statement, rows.emplace_back());
+		} while (true == statement->HasBufferedRow() && true == statement->MoveNext());
+
+		std::pmr::vector<_staging_t> staging(rowArraySize, statement->GetMemoryResource());
+		if (false == statement->BindRows(GetBindings().data(), COLUMN_COUNT, staging.data(), sizeof(_staging_t), rowArraySize))
+		{
+			throw StatementException(statement->GetError());
+		}
+
+		while (true)
+		{
+			SQLULEN fetched = 0;
+			SQLRETURN retcode = statement->FetchRows(fetched);
+			if (SQL_NO_DATA == retcode)
+			{
+				break;
+			}
+
+			if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+			{
+				throw StatementException(statement->GetError());
+			}
+
+			// 블록마다 정확한 크기로 늘리면 매번 재할당되므로 2배씩 늘린다.
+			size_t required = rows.size() + static_cast<size_t>(fetched);
+			if (rows.capacity() < required)
+			{
+				rows.reserve((std::max)(rows.capacity() * 2, required));
+			}
+
+			for (SQLULEN i = 0; i < fetched; ++i)
+			{
+				auto status = statement->GetRowStatus(i);
+				if (SQL_ROW_NOROW == status)
+				{
+					continue;
+				}
+
+				if (SQL_ROW_ERROR == status)
+				{
+					throw StatementException(statement->GetError());
+				}
+
+				auto failedColumn = Assign(rows.emplace_back(), staging[i], std::make_index_sequence<sizeof...(Members)>{});
+				if (0 != failedColumn)
+				{
+					// 일부만 채워진 row는 남기지 않는다.
+					rows.pop_back();
+					throw StatementException(MakeTruncationError(statement, failedColumn));
+				}
+			}
+		}
+	}
+
+private:
+	using _bindings_t = std::array<Statement::RowBinding, sizeof...(Members)>;
+
+	static const _bindings_t& GetBindings()
+	{
+		static const _bindings_t bindings = MakeBindings(std::make_index_sequence<sizeof...(Members)>{});
+		return bindings;
+	}
+
+	template <std::size_t... Is>
+	static _bindings_t MakeBindings(std::index_sequence<Is...>)
+	{
+		_staging_t row{};
+		auto base = reinterpret_cast<const char*>(&row);
+
+		return _bindings_t{
+			Statement::RowBinding{
+				_column_t<Members>::C_TYPE,
+				static_cast<size_t>(reinterpret_cast<const char*>(&std::get<Is>(row).value) - base),
+				static_cast<SQLLEN>(sizeof(std::get<Is>(row).value)),
+				static_cast<size_t>(reinterpret_cast<const char*>(&std::get<Is>(row).indicator) - base)
+			}...
+		};
+	}
+
+	static void ReadCurrent(Statement* statement, _row_t& row)
+	{
+		(_column_t<Members>::Read(statement, row.*Members), ...);
+	}
+
+	// 실패한 컬럼 번호를 반환한다. (1부터 시작, 모두 성공하면 0)
+	template <std::size_t... Is>
+	static SQLUSMALLINT Assign(_row_t& row, const _staging_t& staging, std::index_sequence<Is...>)
+	{
+		SQLUSMALLINT failedColumn = 0;
+		static_cast<void>(((_column_t<Members>::Assign(row.*Members, std::get<Is>(staging).value, std::get<Is>(staging).indicator)
+			|| (failedColumn = static_cast<SQLUSMALLINT>(Is + 1), false)) && ...));
+
+		return failedColumn;
+	}
+
+	// 문자열이 StringCapacity보다 길어 잘린 경우 (22001: String data, right truncation)
+	static _odbc_error_ptr_t MakeTruncationError(Statement* statement, SQLUSMALLINT columnNumber)
+	{
+		std::string message = "RowSchema column " + std::to_string(columnNumber);
+
+		auto info = statement->GetColumnInfo(columnNumber);
+		if (nullptr != info)
+		{
+			message += " (" + info->name + ")";
+		}
+
+		message += " exceeds the string capacity " + std::to_string(StringCapacity) + ".";
+
+		auto error = std::make_shared<OdbcError>(SQL_HANDLE_STMT, SQL_NULL_HANDLE);
+		error->SetError("22001", message);
+
+		return error;
+	}
+};
+
+template <auto... Members>
+using RowSchema = BasicRowSchema<255, Members...>;
+
+class IDataAccessObject
+{
+public:
+	virtual ~IDataAccessObject() = default;
+
+	// 실행 과정에서 에러가 발생할 경우 내용을 공유 합니다.
+	virtual void HandleOdbcException(_odbc_error_ptr_t& err) = 0;
+
+	// 레코드 셋 데이터를 읽기 가능한 상태로 전달한다.
+	virtual bool Parse(Statement* hstmt) = 0;
+
+	// 처리 끝! 결과 처리
+	virtual void Process() = 0;
+
+	// 객체를 재사용(QueryPool)하기 전에 호출된다. 이전 실행 결과를 정리한다.
+	virtual void Reset() {}
+
+	// Parse ~ Process 동안 사용할 수 있는 실행 단위 메모리 리소스
+	// 할당된 메모리는 Process가 끝나면 한번에 해제되므로 이후에도 보관할 데이터에는 사용하면 안된다.
+	inline std::pmr::memory_resource* GetMemoryResource() { return (nullptr == m_memoryResource) ? std::pmr::get_default_resource() : m_memoryResource; }
+
+	inline void SetMemoryResource(std::pmr::memory_resource* resource) { m_memoryResource = resource; }
+
+private:
+	std::pmr::memory_resource* m_memoryResource = nullptr;
+};
+
+class IQuery
+{
+public:
+	// 실행기에서 처리 순서를 결정하는 우선 순위
+	enum class ePriority
+	{
+		Critical = 0,	// 로그인 등 지연에 민감한 요청
+		Normal,
+		Bulk,			// 로그 기록 등 대량/저가치 요청
+		Max
+	};
+
+	virtual ~IQuery() = default;
+
+	virtual bool Build(Statement* statement) = 0;
+
+	virtual const char* GetScript() = 0;
+	virtual IDataAccessObject* GetDao() = 0;
+
+	// SQLFetch 1회에 읽을 row 수 (1일 경우 row 단위)
+	virtual SQLULEN GetRowArraySize() = 0;
+
+	virtual ePriority GetPriority() { return ePriority::Normal; }
+
+	// 같은 키의 쿼리는 실행기(OdbcExecutor)에서 요청 순서대로 하나씩 실행된다. 키가 없으면 false
+	virtual bool GetAffinityKey(uint64_t& /*out_key*/) { return false; }
+
+	// 다시 실행해도 결과가 같은 쿼리인지 여부 (OdbcPool::Execute는 true인 쿼리만 실행 후 실패를 재시도한다.)
+	// 재시도 전에 DAO의 Reset이 호출되므로 DAO는 Reset에서 이전 시도의 결과를 지워야 한다.
+	virtual bool IsIdempotent() { return false; }
+};
+
+// 실행기(OdbcReactor 등)에서 쿼리 실행이 끝난 후 호출되는 콜백
+// 실행 결과와 실행 중 발생한 에러(없을 경우 nullptr)를 전달한다.
+using _query_completion_t = std::function<void(SQLRETURN, _odbc_error_ptr_t&)>;
+
+// 같은 쿼리 객체들이 공유하는 스크립트
+using _script_ptr_t = std::shared_ptr<const std::string>;
+
+// DB 처리를 위한 스크립트 및 속성 값 관리 객체
+template <typename DAO, typename... Args>
+class Query : public IQuery
+{
+public:
+	using _dao_t = DAO;
+
+	explicit Query(std::string_view str)
+		: m_dao(new DAO)
+	{
+		m_query = std::make_shared<const std::string>(str);
+	}
+
+	// 스크립트를 복사하지 않고 공유한다.
+	explicit Query(_script_ptr_t script)
+		: m_dao(new DAO)
+	{
+		m_query = std::move(script);
+	}
+
+	~Query() = default;
+
+	virtual const char* GetScript() override
+	{
+		return m_query->c_str();
+	}
+
+	virtual IDataAccessObject* GetDao() override
+	{
+		return m_dao.get();
+	}
+
+	virtual SQLULEN GetRowArraySize() override
+	{
+		return m_rowArraySize;
+	}
+
+	virtual ePriority GetPriority() override
+	{
+		return m_priority;
+	}
+
+	void SetPriority(ePriority priority)
+	{
+		m_priority = priority;
+	}
+
+	virtual bool GetAffinityKey(uint64_t& out_key) override
+	{
+		out_key = m_affinityKey;
+		return m_hasAffinityKey;
+	}
+
+	// 같은 유저(usn 등)의 쓰기 요청처럼 순서가 필요한 쿼리에 같은 키를 지정한다.
+	void SetAffinityKey(uint64_t key)
+	{
+		m_affinityKey = key;
+		m_hasAffinityKey = true;
+	}
+
+	void ClearAffinityKey()
+	{
+		m_hasAffinityKey = false;
+	}
+
+	virtual bool IsIdempotent() override
+	{
+		return m_isIdempotent;
+	}
+
+	// 조회 등 다시 실행해도 되는 쿼리에 설정한다. (DAO는 Reset을 구현해야 한다.)
+	void SetIdempotent(bool idempotent)
+	{
+		m_isIdempotent = idempotent;
+	}
+
+	// 결과 row가 많은 쿼리는 블록 단위로 읽도록 설정한다.
+	void SetRowArraySize(SQLULEN size)
+	{
+		m_rowArraySize = size;
+	}
+
+	// 재사용 전에 DAO의 이전 결과와 affinity 키, 우선 순위, 블록 크기, 재시도 여부를 정리한다. 파라미터는 다음 SetParameter에서 덮어쓴다.
+	void Reset()
+	{
+		ClearAffinityKey();
+		m_priority = ePriority::Normal;
+		m_rowArraySize = 1;
+		m_isIdempotent = false;
+		m_dao->Reset();
+	}
+
+	// 인자는 보관 중인 파라미터에 그대로 전달(perfect forwarding)되어 대입된다.
+	// 우측값은 이동되며 좌측값 문자열은 기존 버퍼를 재사용하여 복사된다.
+	// FixedString 파라미터의 Capacity를 넘는 문자열이 있으면 false를 반환하며 이 경우 실행하지 않아야 한다.
+	template <typename... Params>
+	bool SetParameter(Params&&... args)
+	{
+		static_assert(sizeof...(Params) == sizeof...(Args), "The number of parameters does not match.");
+
+		return AssignParameters(std::index_sequence_for<Args...>{}, std::forward<Params>(args)...);
+	}
+
+	virtual bool Build(Statement* statement) override
+	{
+		if (nullptr == statement)
+		{
+			return false;
+		}
+
+		m_statement = statement;
+
+		MakeParameters(m_parameters, std::index_sequence_for<Args...>{});
+
+		return true;
+	}
+
+private:
+	template <std::size_t... Is, typename... Params>
+	bool AssignParameters(std::index_sequence<Is...>, Params&&... args)
+	{
+		bool isAssigned = true;
+		((isAssigned = AssignParameter(std::get<Is>(m_parameters), std::forward<Params>(args)) && isAssigned), ...);
+
+		return isAssigned;
+	}
+
+	template <typename T, typename Param>
+	static bool AssignParameter(T& parameter, Param&& value)
+	{
+		// 잘린 문자열이 실행되지 않도록 결과를 확인한다.
+		if constexpr (IsFixedString<T>::value)
+		{
+			return parameter.Assign(std::string_view(value));
+		}
+		else
+		{
+			parameter = std::forward<Param>(value);
+			return true;
+		}
+	}
+
+	template <typename Tuple, std::size_t... Is>
+	void MakeParameters(const Tuple& t, std::index_sequence<Is...>)
+	{
+		(
+			AddParam(std::get<Is>(t), m_indicators[Is]),
+			...
+			);
+
+	}
+
+	template <typename T>
+	bool AddParam(const T& value, SQLLEN& indicator)
+	{
+		// 길이가 필요한 string_view는 쿼리가 보관하는 indicator를 사용한다.
+		if constexpr (std::is_same_v<T, std::string_view>)
+		{
+			return m_statement->AddParam(value, indicator);
+		}
+		else
+		{
+			return m_statement->AddParam(value);
+		}
+	}
+
+	Statement* m_statement;
+
+	_script_ptr_t m_query;
+	std::tuple<Args...> m_parameters;
+	std::array<SQLLEN, sizeof...(Args)> m_indicators = {};
+	SQLULEN m_rowArraySize = 1;
+	ePriority m_priority = ePriority::Normal;
+	uint64_t m_affinityKey = 0;
+	bool m_hasAffinityKey = false;
+	bool m_isIdempotent = false;
+
+	std::unique_ptr<IDataAccessObject> m_dao;
+};
+
+// BatchQuery 파라미터 컬럼 (column-wise 배열)
+template <typename T>
+class BatchParameter
+{
+	static_assert(std::is_arithmetic_v<T>, "A BatchQuery parameter must be an arithmetic type or std::string.");
+
+	// vector<bool>은 연속된 버퍼가 아니므로 SQL_C_BIT 크기로 보관한다.
+	using _storage_t = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+
+public:
+	inline void Reserve(size_t count) { m_values.reserve(count); }
+	inline void Clear() { m_values.clear(); }
+	inline void Add(const T& value) { m_values.push_back(static_cast<_storage_t>(value)); }
+
+	bool Bind(Statement* statement)
+	{
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			return statement->AddParamArray(reinterpret_cast<const bool*>(m_values.data()), nullptr);
+		}
+		else
+		{
+			return statement->AddParamArray(m_values.data(), nullptr);
+		}
+	}
+
+private:
+	std::vector<_storage_t> m_values;
+};
+
+template <>
+class BatchParameter<std::string>
+{
+public:
+	inline void Reserve(size_t count) { m_values.reserve(count); }
+	inline void Clear() { m_values.clear(); }
+	inline void Add(const std::string& value) { m_values.push_back(value); }
+	inline void Add(std::string&& value) { m_values.push_back(std::move(value)); }
+
+	// 가장 긴 문자열 크기로 연속된 버퍼를 만들어 바인딩한다.
+	bool Bind(Statement* statement)
+	{
+		size_t maxLength = 0;
+		for (const auto& value : m_values)
+		{
+			maxLength = (std::max)(maxLength, value.length());
+		}
+
+		SQLLEN width = static_cast<SQLLEN>(maxLength + 1);
+
+		m_buffer.assign(width * m_values.size(), 0x00);
+		m_lengths.resize(m_values.size());
+
+		for (size_t i = 0; i < m_values.size(); ++i)
+		{
+			memcpy(m_buffer.data() + (width * i), m_values[i].data(), m_values[i].length());
+			m_lengths[i] = static_cast<SQLLEN>(m_values[i].length());
+		}
+
+		return statement->AddParamArray(m_buffer.data(), width, m_lengths.data());
+	}
+
+private:
+	std::vector<std::string> m_values;
+	std::vector<char> m_buffer;
+	std::vector<SQLLEN> m_lengths;
+};
+
+// 같은 스크립트를 여러 파라미터 셋으로 한번에 실행하기 위한 객체 (SQL_ATTR_PARAMSET_SIZE)
+// AddParameter로 추가된 파라미터 셋 수 만큼 1회의 Execute로 처리되며 셋별 결과는 GetParamStatus로 확인한다.
+template <typename DAO, typename... Args>
+class BatchQuery : public IQuery
+{
+public:
+	using _dao_t = DAO;
+
+	explicit BatchQuery(std::string_view str)
+		: m_dao(new DAO)
+	{
+		m_query = std::make_shared<const std::string>(str);
+	}
+
+	// 스크립트를 복사하지 않고 공유한다.
+	explicit BatchQuery(_script_ptr_t script)
+		: m_dao(new DAO)
+	{
+		m_query = std::move(script);
+	}
+
+	~BatchQuery() = default;
+
+	virtual const char* GetScript() override
+	{
+		return m_query->c_str();
+	}
+
+	virtual IDataAccessObject* GetDao() override
+	{
+		return m_dao.get();
+	}
+
+	virtual SQLULEN GetRowArraySize() override
+	{
+		return m_rowArraySize;
+	}
+
+	virtual ePriority GetPriority() override
+	{
+		return m_priority;
+	}
+
+	void SetPriority(ePriority priority)
+	{
+		m_priority = priority;
+	}
+
+	virtual bool GetAffinityKey(uint64_t& out_key) override
+	{
+		out_key = m_affinityKey;
+		return m_hasAffinityKey;
+	}
+
+	// 같은 유저(usn 등)의 쓰기 요청처럼 순서가 필요한 쿼리에 같은 키를 지정한다.
+	void SetAffinityKey(uint64_t key)
+	{
+		m_affinityKey = key;
+		m_hasAffinityKey = true;
+	}
+
+	void ClearAffinityKey()
+	{
+		m_hasAffinityKey = false;
+	}
+
+	virtual bool IsIdempotent() override
+	{
+		return m_isIdempotent;
+	}
+
+	// 조회 등 다시 실행해도 되는 쿼리에 설정한다. (DAO는 Reset을 구현해야 한다.)
+	void SetIdempotent(bool idempotent)
+	{
+		m_isIdempotent = idempotent;
+	}
+
+	void SetRowArraySize(SQLULEN size)
+	{
+		m_rowArraySize = size;
+	}
+
+	void Reserve(size_t count)
+	{
+		std::apply([count](auto&... column) { (column.Reserve(count), ...); }, m_columns);
+	}
+
+	// 파라미터 셋 1개를 추가한다.
+	template <typename... Params>
+	void AddParameter(Params&&... args)
+	{
+		static_assert(sizeof...(Params) == sizeof...(Args), "The number of parameters does not match.");
+
+		AddParameters(std::index_sequence_for<Args...>{}, std::forward<Params>(args)...);
+		++m_count;
+	}
+
+	// 재사용 전에 파라미터, affinity 키, 우선 순위, 블록 크기, 재시도 여부와 DAO의 이전 결과를 정리한다.
+	void Reset()
+	{
+		ClearParameters();
+		ClearAffinityKey();
+		m_priority = ePriority::Normal;
+		m_rowArraySize = 1;
+		m_isIdempotent = false;
+		m_dao->Reset();
+	}
+
+	void ClearParameters()
+	{
+		std::apply([](auto&... column) { (column.Clear(), ...); }, m_columns);
+		m_count = 0;
+	}
+
+	inline size_t GetParameterCount() { return m_count; }
+
+	// 실행 중 처리된 파라미터 셋 수
+	inline SQLULEN GetProcessedCount() { return m_processed; }
+
+	// 파라미터 셋별 결과 (SQL_PARAM_SUCCESS, SQL_PARAM_SUCCESS_WITH_INFO, SQL_PARAM_ERROR, SQL_PARAM_UNUSED, SQL_PARAM_DIAG_UNAVAILABLE)
+	inline SQLUSMALLINT GetParamStatus(size_t index) { return m_status[index]; }
+
+	virtual bool Build(Statement* statement) override
+	{
+		if (nullptr == statement || 0 == m_count)
+		{
+			return false;
+		}
+
+		m_status.assign(m_count, SQL_PARAM_UNUSED);
+		m_processed = 0;
+
+		if (false == statement->SetParamSetSize(m_count, m_status.data(), &m_processed))
+		{
+			return false;
+		}
+
+		return std::apply([statement](auto&... column) { return (column.Bind(statement) && ...); }, m_columns);
+	}
+
+private:
+	template <std::size_t... Is, typename... Params>
+	void AddParameters(std::index_sequence<Is...>, Params&&... args)
+	{
+		(std::get<Is>(m_columns).Add(std::forward<Params>(args)), ...);
+	}
+
+	_script_ptr_t m_query;
+	std::tuple<BatchParameter<Args>...> m_columns;
+	size_t m_count = 0;
+	SQLULEN m_rowArraySize = 1;
+	ePriority m_priority = ePriority::Normal;
+	uint64_t m_affinityKey = 0;
+	bool m_hasAffinityKey = false;
+	bool m_isIdempotent = false;
+
+	std::vector<SQLUSMALLINT> m_status;
+	SQLULEN m_processed = 0;
+
+	std::unique_ptr<IDataAccessObject> m_dao;
+};
+
+// 쿼리 객체(Query<DAO, Args...> 등) 재사용 풀
+// 쓰레드별 free list를 우선 사용하며 넘치는 객체는 공용 overflow 목록에 보관한다.
+// Acquire로 받은 객체는 마지막 참조가 해제될 때 Reset 후 자동으로 반환되며 스크립트는 풀의 객체들이 공유한다.
+template <typename QueryT>
+class QueryPool
+{
+public:
+	struct Stats
+	{
+		uint64_t localHit = 0;
+		uint64_t globalHit = 0;
+		uint64_t miss = 0;
+		uint64_t discard = 0;
+
+		// 새로 생성하지 않고 재사용된 비율
+		double GetHitRate() const
+		{
+			uint64_t total = localHit + globalHit + miss;
+			return (0 == total) ? 0.0 : static_cast<double>(localHit + globalHit) / static_cast<double>(total);
+		}
+	};
+
+	QueryPool(std::string_view script, size_t localCapacity = 64, size_t globalCapacity = 1024)
+		: m_shared(std::make_shared<Shared>())
+	{
+		m_shared->ids = GetIdAllocator();
+		m_shared->id = m_shared->ids->Allocate();
+		m_shared->script = std::make_shared<const std::string>(script);
+		m_shared->localCapacity = localCapacity;
+		m_shared->globalCapacity = globalCapacity;
+	}
+
+	std::shared_ptr<QueryT> Acquire()
+	{
+		auto& shared = m_shared;
+
+		QueryT* query = nullptr;
+
+		auto local = GetLocal(shared);
+		if (nullptr != local && false == local->items.empty())
+		{
+			query = local->items.back();
+			local->items.pop_back();
+			++shared->localHit;
+		}
+		else
+		{
+			{
+				std::lock_guard<std::mutex> lock(shared->mutex);
+				if (false == shared->overflow.empty())
+				{
+					query = shared->overflow.back();
+					shared->overflow.pop_back();
+				}
+			}
+
+			if (nullptr != query)
+			{
+				++shared->globalHit;
+			}
+			else
+			{
+				query = new QueryT(shared->script);
+				++shared->miss;
+			}
+		}
+
+		return std::shared_ptr<QueryT>(query, Recycler{ shared });
+	}
+
+	Stats GetStats()
+	{
+		Stats stats;
+		stats.localHit = m_shared->localHit;
+		stats.globalHit = m_shared->globalHit;
+		stats.miss = m_shared->miss;
+		stats.discard = m_shared->discard;
+
+		return stats;
+	}
+
+	inline const _script_ptr_t& GetScript() { return m_shared->script; }
+
+private:
+	// 쓰레드별 목록이 계속 늘어나지 않도록 해제된 풀의 id를 재사용한다.
+	struct IdAllocator
+	{
+		size_t Allocate()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (true == freeIds.empty())
+			{
+				return next++;
+			}
+
+			size_t id = freeIds.back();
+			freeIds.pop_back();
+			return id;
+		}
+
+		void Free(size_t id)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			freeIds.push_back(id);
+		}
+
+		std::mutex mutex;
+		std::vector<size_t> freeIds;
+		size_t next = 0;
+	};
+
+	struct Shared
+	{
+		~Shared()
+		{
+			for (auto query : overflow)
+			{
+				delete query;
+			}
+
+			if (nullptr != ids)
+			{
+				ids->Free(id);
+			}
+		}
+
+		// 용량을 넘는 객체는 삭제한다.
+		void Overflow(QueryT* query)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (overflow.size() < globalCapacity)
+				{
+					overflow.push_back(query);
+					return;
+				}
+			}
+
+			++discard;
+			delete query;
+		}
+
+		// 정적 객체의 해제 순서와 무관하도록 참조로 보관한다.
+		std::shared_ptr<IdAllocator> ids;
+		size_t id = 0;
+		_script_ptr_t script;
+		size_t localCapacity = 0;
+		size_t globalCapacity = 0;
+
+		std::mutex mutex;
+		std::vector<QueryT*> overflow;
+
+		std::atomic_uint64_t localHit = 0;
+		std::atomic_uint64_t globalHit = 0;
+		std::atomic_uint64_t miss = 0;
+		std::atomic_uint64_t discard = 0;
+	};
+
+	// 쓰레드별 free list (풀 id로 구분)
+	// 쓰레드가 풀의 수명을 늘리지 않도록 약한 참조로 보관한다.
+	struct LocalList
+	{
+		std::weak_ptr<Shared> owner;
+		std::vector<QueryT*> items;
+	};
+
+	// 쓰레드가 종료되면 남은 객체는 공용 목록으로 옮긴다. (풀이 이미 해제된 경우 삭제한다.)
+	struct LocalCache
+	{
+		~LocalCache()
+		{
+			IsLocalDestroyed() = true;
+
+			for (auto& list : lists)
+			{
+				auto owner = list.owner.lock();
+				for (auto query : list.items)
+				{
+					if (nullptr != owner)
+					{
+						owner->Overflow(query);
+					}
+					else
+					{
+						delete query;
+					}
+				}
+			}
+		}
+
+		std::vector<LocalList> lists;
+	};
+
+	struct Recycler
+	{
+		void operator()(QueryT* query)
+		{
+			query->Reset();
+
+			auto local = GetLocal(shared);
+			if (nullptr != local && local->items.size() < shared->localCapacity)
+			{
+				local->items.push_back(query);
+				return;
+			}
+
+			shared->Overflow(query);
+		}
+
+		std::shared_ptr<Shared> shared;
+	};
+
+	// 쓰레드 종료 중 free list가 이미 해제된 경우 nullptr (공용 목록을 사용한다.)
+	static LocalList* GetLocal(const std::shared_ptr<Shared>& shared)
+	{
+		if (true == IsLocalDestroyed())
+		{
+			return nullptr;
+		}
+
+		thread_local LocalCache cache;
+
+		if (cache.lists.size() <= shared->id)
+		{
+			cache.lists.resize(shared->id + 1);
+		}
+
+		// 재사용된 id이면 해제된 풀의 객체가 남아 있을 수 있으므로 삭제한다.
+		auto& list = cache.lists[shared->id];
+		if (true == list.owner.expired())
+		{
+			for (auto query : list.items)
+			{
+				delete query;
+			}
+
+			list.items.clear();
+			list.owner = shared;
+		}
+
+		return &list;
+	}
+
+	// 소멸자가 없는 값이므로 LocalCache가 해제된 후에도 확인할 수 있다.
+	static bool& IsLocalDestroyed()
+	{
+		thread_local bool destroyed = false;
+		return destroyed;
+	}
+
+	static const std::shared_ptr<IdAllocator>& GetIdAllocator()
+	{
+		static const std::shared_ptr<IdAllocator> ids = std::make_shared<IdAllocator>();
+		return ids;
+	}
+
+	std::shared_ptr<Shared> m_shared;
+};
+
+// 실행 단위 arena (monotonic)
+// 초기 버퍼를 재사용하며 이를 넘는 할당은 upstream에서 블록 단위로 받은 후 실행이 끝나면 한번에 해제한다.
+// 연결을 사용하는 쓰레드에서만 사용한다.
+class ExecutionArena
+{
+public:
+	explicit ExecutionArena(size_t initialSize)
+		: m_buffer((std::max)(initialSize, MIN_INITIAL_SIZE))
+		, m_resource(m_buffer.data(), m_buffer.size())
+	{
+	}
+
+	inline std::pmr::memory_resource* GetResource() { return &m_resource; }
+
+	inline void Enter() { ++m_depth; }
+
+	// 중첩 실행(MARS)이 모두 끝났을 때 해제한다.
+	void Leave()
+	{
+		if (0 == --m_depth)
+		{
+			m_resource.release();
+		}
+	}
+
+private:
+	static constexpr size_t MIN_INITIAL_SIZE = 1024;
+
+	std::vector<std::byte> m_buffer;
+	std::pmr::monotonic_buffer_resource m_resource;
+	int32_t m_depth = 0;
+};
+
+// 마이크로초 단위 값을 log-linear 구간(HDR 방식)으로 세는 히스토그램
+// 2의 거듭제곱 구간마다 SUB_BUCKET_COUNT개의 선형 구간을 두어 상대 오차는 1/SUB_BUCKET_COUNT 이하이다.
+// 기록은 relaxed atomic 증가로만 이루어지므로 여러 쓰레드에서 동시에 기록할 수 있다.
+class LatencyHistogram
+{
+public:
+	static constexpr uint32_t SUB_BUCKET_BITS = 3;
+	static constexpr uint64_t SUB_BUCKET_COUNT = (1ull << SUB_BUCKET_BITS);
+
+	// 2^40us(약 12일) 이상은 마지막 구간에 기록한다.
+	static constexpr uint32_t MAX_VALUE_BITS = 40;
+	static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+	struct Snapshot
+	{
+		std::array<uint64_t, BUCKET_COUNT> buckets = {};
+		uint64_t count = 0;
+		uint64_t sum = 0;
+		uint64_t max = 0;
+
+		inline uint64_t GetMean() const { return (0 == count) ? 0 : sum / count; }
+
+		// ratio(0.0 ~ 1.0)에 해당하는 값이 속한 구간의 상한을 반환한다. (최대값을 넘지 않는다.)
+		uint64_t GetPercentile(double ratio) const
+		{
+			if (0 == count)
+			{
+				return 0;
+			}
+
+			uint64_t rank = static_cast<uint64_t>(ratio * static_cast<double>(count) + 0.5);
+			rank = (std::min)((std::max)(rank, static_cast<uint64_t>(1)), count);
+
+			uint64_t accumulated = 0;
+			for (size_t i = 0; i < BUCKET_COUNT; ++i)
+			{
+				accumulated += buckets[i];
+				if (rank <= accumulated)
+				{
+					return (std::min)(ToUpperBound(i), max);
+				}
+			}
+
+			return max;
+		}
+
+		void Merge(const Snapshot& other)
+		{
+			for (size_t i = 0; i < BUCKET_COUNT; ++i)
+			{
+				buckets[i] += other.buckets[i];
+			}
+
+			count += other.count;
+			sum += other.sum;
+			max = (std::max)(max, other.max);
+		}
+	};
+
+	LatencyHistogram() = default;
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	void Record(int64_t us)
+	{
+		uint64_t value = static_cast<uint64_t>((std::max)(us, static_cast<int64_t>(0)));
+
+		m_buckets[ToIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+		m_sum.fetch_add(value, std::memory_order_relaxed);
+
+		uint64_t max = m_max.load(std::memory_order_relaxed);
+		while (max < value && false == m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	// 기록 중에도 호출할 수 있으며 구간별로 읽으므로 count와 구간 합이 약간 다를 수 있다.
+	void GetSnapshot(Snapshot& out_snapshot) const
+	{
+		for (size_t i = 0; i < BUCKET_COUNT; ++i)
+		{
+			out_snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+		}
+
+		out_snapshot.count = m_count.load(std::memory_order_relaxed);
+		out_snapshot.sum = m_sum.load(std::memory_order_relaxed);
+		out_snapshot.max = m_max.load(std::memory_order_relaxed);
+	}
+
+	static size_t ToIndex(uint64_t value)
+	{
+		if (value < SUB_BUCKET_COUNT)
+		{
+			return static_cast<size_t>(value);
+		}
+
+		uint32_t bit = HighestBit(value);
+		if (MAX_VALUE_BITS <= bit)
+		{
+			return BUCKET_COUNT - 1;
+		}
+
+		uint32_t shift = bit - SUB_BUCKET_BITS;
+		return static_cast<size_t>((shift + 1) * SUB_BUCKET_COUNT + ((value >> shift) & (SUB_BUCKET_COUNT - 1)));
+	}
+
+	// index 구간에 속하는 가장 큰 값
+	static uint64_t ToUpperBound(size_t index)
+	{
+		if (index < SUB_BUCKET_COUNT)
+		{
+			return static_cast<uint64_t>(index);
+		}
+
+		uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+		uint64_t sub = index % SUB_BUCKET_COUNT;
+		return ((SUB_BUCKET_COUNT + sub + 1) << shift) - 1;
+	}
+
+private:
+	static inline uint32_t HighestBit(uint64_t value)
+	{
+		uint32_t bit = 0;
+		for (uint32_t step = 32; 0 < step; step >>= 1)
+		{
+			if (0 != (value >> step))
+			{
+				value >>= step;
+				bit += step;
+			}
+		}
+
+		return bit;
+	}
+
+	std::array<std::atomic_uint64_t, BUCKET_COUNT> m_buckets = {};
+	std::atomic_uint64_t m_count = 0;
+	std::atomic_uint64_t m_sum = 0;
+	std::atomic_uint64_t m_max = 0;
+};
+
+// 쿼리 스크립트별 실행 단계 시간과 읽은 row, byte 수
+// 연결(Odbc)들이 공유하며 OdbcPool::Monitor가 소유한다.
+class QueryMetrics
+{
+public:
+	enum class ePhase
+	{
+		Checkout = 0,	// 연결을 받기까지 기다린 시간 (연결을 받은 후 첫 실행에만 포함)
+		Prepare,
+		Execute,
+		Fetch,			// Fetch, Parse, Process
+		Total,
+		Max
+	};
+
+	static const char* NamedPhase(ePhase phase)
+	{
+		switch (phase)
+		{
+		case ePhase::Checkout: return "checkout";
+		case ePhase::Prepare: return "prepare";
+		case ePhase::Execute: return "execute";
+		case ePhase::Fetch: return "fetch";
+		case ePhase::Total: return "total";
+		default: return "unknown";
+		}
+	}
+
+	// 실행 1회의 단계별 시각
+	struct Sample
+	{
+		std::chrono::steady_clock::time_point begin;
+		std::chrono::steady_clock::time_point prepared;
+		std::chrono::steady_clock::time_point executed;
+
+		// 연결을 기다린 시간 (us, 0보다 작으면 없음)
+		int64_t checkoutWait = -1;
+
+		void Begin(int64_t wait)
+		{
+			begin = prepared = executed = std::chrono::steady_clock::now();
+			checkoutWait = wait;
+		}
+	};
+
+	struct Snapshot
+	{
+		std::string script;
+		std::array<LatencyHistogram::Snapshot, static_cast<size_t>(ePhase::Max)> phases;
+		uint64_t error = 0;
+		uint64_t rows = 0;
+		uint64_t bytes = 0;
+
+		inline const LatencyHistogram::Snapshot& Get(ePhase phase) const { return phases[static_cast<size_t>(phase)]; }
+	};
+
+	QueryMetrics() = default;
+	QueryMetrics(const QueryMetrics&) = delete;
+	QueryMetrics& operator=(const QueryMetrics&) = delete;
+
+	void Record(const char* script, const Sample& sample, bool success, uint64_t rows, uint64_t bytes)
+	{
+		using namespace std::chrono;
+
+		auto end = steady_clock::now();
+		auto prepared = (std::max)(sample.prepared, sample.begin);
+		auto executed = (std::max)(sample.executed, prepared);
+
+		auto& entry = Lookup(script);
+		if (0 <= sample.checkoutWait)
+		{
+			entry.Get(ePhase::Checkout).Record(sample.checkoutWait);
+		}
+
+		entry.Get(ePhase::Prepare).Record(duration_cast<microseconds>(prepared - sample.begin).count());
+		entry.Get(ePhase::Execute).Record(duration_cast<microseconds>(executed - prepared).count());
+		entry.Get(ePhase::Fetch).Record(duration_cast<microseconds>(end - executed).count());
+		entry.Get(ePhase::Total).Record(duration_cast<microseconds>(end - sample.begin).count() + (std::max)(sample.checkoutWait, static_cast<int64_t>(0)));
+
+		if (false == success)
+		{
+			entry.error.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		entry.rows.fetch_add(rows, std::memory_order_relaxed);
+		entry.bytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	// 스크립트별 현황을 반환한다. 최대 스크립트 수를 넘어 합산된 기록은 script가 빈 문자열이다.
+	std::vector<Snapshot> GetSnapshot()
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+		std::vector<Snapshot> snapshots(m_entries.size() + 1);
+
+		size_t index = 0;
+		for (auto& [key, entry] : m_entries)
+		{
+			entry->GetSnapshot(snapshots[index++]);
+		}
+
+		m_overflow.GetSnapshot(snapshots[index]);
+		if (0 == snapshots[index].Get(ePhase::Total).count)
+		{
+			snapshots.pop_back();
+		}
+
+		return snapshots;
+	}
+
+private:
+	// 동적으로 생성된 스크립트로 인해 무한히 늘어나지 않도록 제한한다.
+	static constexpr size_t MAX_SCRIPT_COUNT = 256;
+
+	struct Entry
+	{
+		std::string script;
+		std::array<LatencyHistogram, static_cast<size_t>(ePhase::Max)> phases;
+		std::atomic_uint64_t error = 0;
+		std::atomic_uint64_t rows = 0;
+		std::atomic_uint64_t bytes = 0;
+
+		inline LatencyHistogram& Get(ePhase phase) { return phases[static_cast<size_t>(phase)]; }
+
+		void GetSnapshot(Snapshot& out_snapshot)
+		{
+			out_snapshot.script = script;
+			for (size_t i = 0; i < phases.size(); ++i)
+			{
+				phases[i].GetSnapshot(out_snapshot.phases[i]);
+			}
+
+			out_snapshot.error = error.load(std::memory_order_relaxed);
+			out_snapshot.rows = rows.load(std::memory_order_relaxed);
+			out_snapshot.bytes = bytes.load(std::memory_order_relaxed);
+		}
+	};
+
+	Entry& Lookup(const char* script)
+	{
+		std::string_view key = (nullptr == script) ? std::string_view() : std::string_view(script);
+
+		{
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+			auto itr = m_entries.find(key);
+			if (m_entries.end() != itr)
+			{
+				return *itr->second;
+			}
+		}
+
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+		auto itr = m_entries.find(key);
+		if (m_entries.end() != itr)
+		{
+			return *itr->second;
+		}
+
+		if (MAX_SCRIPT_COUNT <= m_entries.size())
+		{
+			return m_overflow;
+		}
+
+		// 키는 Entry가 가진 문자열을 가리킨다.
+		auto entry = std::make_unique<Entry>();
+		entry->script = key;
+
+		auto& result = *entry;
+		m_entries.emplace(std::string_view(result.script), std::move(entry));
+
+		return result;
+	}
+
+	std::shared_mutex m_mutex;
+	std::unordered_map<std::string_view, std::unique_ptr<Entry>> m_entries;
+	Entry m_overflow;
+};
+
+// 프로세스에서 공유하는 ODBC 환경(SQLHENV)
+// 연결 객체들이 참조하는 동안 유지되며 마지막 참조가 해제되면 해제된다.
+// 드라이버 매니저 연결 풀링(SQL_CP_ONE_PER_HENV)을 사용하면 SQLDisconnect된 연결이 환경에 보관되어
+// 같은 연결 문자열로 다시 연결할 때 재사용된다.
+class OdbcEnvironment
+{
+public:
+	~OdbcEnvironment()
+	{
+		if (SQL_NULL_HENV != m_hEnv)
+		{
+			SQLFreeHandle(SQL_HANDLE_ENV, m_hEnv);
+		}
+	}
+
+	OdbcEnvironment(const OdbcEnvironment&) = delete;
+	OdbcEnvironment& operator=(const OdbcEnvironment&) = delete;
+
+	inline SQLHENV GetHandle() { return m_hEnv; }
+	inline bool IsConnectionPooling() { return m_isConnectionPooling; }
+
+	// 환경이 생성되기 전에 설정해야 적용된다. (이미 생성된 경우 모든 참조가 해제된 후 다시 생성될 때 적용)
+	static void EnableConnectionPooling(bool enable)
+	{
+		std::lock_guard<std::mutex> lock(GetMutex());
+		GetConnectionPoolingOption() = enable;
+	}
+
+	// 공유 환경을 받는다. 없을 경우 생성하며 실패하면 nullptr을 반환한다.
+	static std::shared_ptr<OdbcEnvironment> Acquire()
+	{
+		std::lock_guard<std::mutex> lock(GetMutex());
+
+		auto& shared = GetShared();
+
+		auto environment = shared.lock();
+		if (nullptr != environment)
+		{
+			return environment;
+		}
+
+		environment.reset(new OdbcEnvironment);
+		if (false == environment->Setup(GetConnectionPoolingOption()))
+		{
+			return nullptr;
+		}
+
+		shared = environment;
+
+		return environment;
+	}
+
+private:
+	OdbcEnvironment() = default;
+
+	bool Setup(bool isConnectionPooling)
+	{
+		SQLRETURN retcode = SQL_ERROR;
+
+		// 연결 풀링은 프로세스 단위 속성이므로 환경 할당 전에 설정한다.
+		if (true == isConnectionPooling)
+		{
+			retcode = SQLSetEnvAttr(SQL_NULL_HENV, SQL_ATTR_CONNECTION_POOLING, (SQLPOINTER)SQL_CP_ONE_PER_HENV, SQL_IS_INTEGER);
+			if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+			{
+				return false;
+			}
+		}
+
+		// Allocate an environment.
+		retcode = SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &m_hEnv);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			m_hEnv = SQL_NULL_HENV;
+			return false;
+		}
+
+		// Register this as an application that expects 3.x behavior, you must register something if you use AllocHandle.
+		retcode = SQLSetEnvAttr(m_hEnv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, SQL_IS_INTEGER);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			return false;
+		}
+
+		m_isConnectionPooling = isConnectionPooling;
+
+		return true;
+	}
+
+	static std::mutex& GetMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static std::weak_ptr<OdbcEnvironment>& GetShared()
+	{
+		static std::weak_ptr<OdbcEnvironment> shared;
+		return shared;
+	}
+
+	static bool& GetConnectionPoolingOption()
+	{
+		static bool isConnectionPooling = false;
+		return isConnectionPooling;
+	}
+
+	SQLHENV m_hEnv = SQL_NULL_HENV;
+	bool m_isConnectionPooling = false;
+};
+
+// DB 연결 객체
+class Odbc
+{
+public:
+	enum class eState
+	{
+		None = 0,
+		Free,
+		Used
+	};
+
+	Odbc()
+		: m_hDbc(SQL_NULL_HDBC)
+		, m_hEnv(SQL_NULL_HENV)
+		, m_query(nullptr)
+		, m_state(eState::None)
+	{
+	}
+
+	~Odbc()
+	{
+		CleanUp();
+	}
+
+private:
+	struct CachedStatement;
+
+public:
+
+	// 준비된 Statement 캐시 통계
+	struct StatementCacheStats
+	{
+		uint64_t hit = 0;
+		uint64_t miss = 0;
+		uint64_t eviction = 0;
+	};
+
+	inline void SetState(eState state) { m_state = state; }
+	inline bool IsFree() { return (m_state == eState::Free); }
+	inline bool IsUsed() { return (m_state == eState::Used); }
+	inline bool IsActive() { return (m_state != eState::None); }
+	
+	bool SetFreeState() 
+	{
+		eState state = eState::Used;
+		return m_state.compare_exchange_strong(state, eState::Free);
+	}
+
+	// 마지막으로 확인된 풀의 세대 (OdbcPool에서 지연 검증에 사용)
+	inline uint64_t GetGeneration() { return m_generation; }
+	inline void SetGeneration(uint64_t generation) { m_generation = generation; }
+
+	// 연결된 시각 (OdbcPool에서 최대 수명 확인에 사용)
+	inline std::chrono::steady_clock::time_point GetConnectedTime() { return m_connectedTime; }
+
+	// 실행 단계별 시간을 기록할 대상 (nullptr일 경우 기록하지 않음)
+	inline void SetQueryMetrics(std::shared_ptr<QueryMetrics> queryMetrics) { m_queryMetrics = std::move(queryMetrics); }
+
+	// 풀에서 연결을 받기까지 기다린 시간 (us). 이후 첫 실행의 기록에 포함된다.
+	inline void SetCheckoutWait(int64_t us) { m_checkoutWait = us; }
+
+	// 드라이버가 알고 있는 연결 상태를 확인한다. (서버와 통신하지 않는다.)
+	bool IsConnectionDead()
+	{
+		if (SQL_NULL_HDBC == m_hDbc)
+		{
+			return true;
+		}
+
+		SQLUINTEGER dead = SQL_CD_FALSE;
+		auto sqlResultCode = SQLGetConnectAttr(m_hDbc, SQL_ATTR_CONNECTION_DEAD, &dead, SQL_IS_UINTEGER, nullptr);
+		if (SQL_SUCCESS != sqlResultCode && SQL_SUCCESS_WITH_INFO != sqlResultCode)
+		{
+			return true;
+		}
+
+		return (SQL_CD_TRUE == dead);
+	}
+
+	bool Setup(const char* connectionString, _logging_ptr_t& logging)
+	{
+		
+		m_hEnv = AllocENV();
+		if (m_hEnv == nullptr)
+		{
+			return false;
+		}
+
+		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Allocate an environment.");
+
+		m_hDbc = AllocDBC(m_hEnv, connectionString);
+		if (m_hDbc == nullptr)
+		{
+			// 공유 환경은 참조만 해제한다.
+			m_environment.reset();
+			m_hEnv = SQL_NULL_HENV;
+
+			return false;
+		}
+
+		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Allocate an DBC.");
+
+		m_logging = logging;
+		
+		// 기본 Statement 1개를 미리 할당한다.
+		{
+			std::lock_guard<std::mutex> lock(m_statementMutex);
+			if (nullptr == NewStatement())
+			{
+				return false;
+			}
+		}
+
+		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Allocate an statement.");
+
+		m_connectedTime = std::chrono::steady_clock::now();
+
+		return true;
+	}
+
+	void CleanUp()
+	{
+		// 비활성화 상태
+		SetState(eState::None);
+
+		ClearStatementCache();
+
+		if (m_hDbc != nullptr)
+		{
+			SQLDisconnect(m_hDbc);
+			SQLFreeHandle(SQL_HANDLE_DBC, m_hDbc);
+			m_hDbc = SQL_NULL_HANDLE;
+		}
+
+		// 공유 환경은 마지막 연결이 해제될 때 해제된다.
+		m_environment.reset();
+		m_hEnv = SQL_NULL_HENV;
+
+		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Completed.");
+	}
+
+	// BindQuery로 바인딩된 쿼리가 사용하는 Statement
+	inline Statement& GetStatement()
+	{
+		return m_current->statement;
+	}
+
+	// 스크립트별로 보관할 준비된 Statement 수. 0일 경우 매 실행마다 Prepare 한다.
+	void SetStatementCacheCapacity(size_t capacity)
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		m_statementCacheCapacity = capacity;
+		TrimStatementCache();
+	}
+
+	// 실행 단위 arena 초기 버퍼 크기. 0일 경우 사용하지 않는다.
+	void SetArenaSize(size_t size)
+	{
+		m_arena = (0 == size) ? nullptr : std::make_unique<ExecutionArena>(size);
+	}
+
+	// 하나의 연결에서 동시에 열 수 있는 Statement 수 (MARS)
+	void SetMaxStatementCount(size_t count)
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		m_maxStatementCount = (std::max)(count, static_cast<size_t>(1));
+	}
+
+	// 이후 할당되는 Statement의 실행 제한 시간 (초, 0일 경우 제한 없음)
+	void SetQueryTimeout(SQLULEN seconds)
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		m_queryTimeout = seconds;
+	}
+
+	StatementCacheStats GetStatementCacheStats()
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		return m_statementCacheStats;
+	}
+
+	// 마지막 호출 이후 누적된 통계를 반환하고 초기화한다.
+	StatementCacheStats TakeStatementCacheStats()
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		StatementCacheStats stats = m_statementCacheStats;
+		m_statementCacheStats = StatementCacheStats{};
+
+		return stats;
+	}
+
+	bool BindQuery(IQuery* query)
+	{
+		if (nullptr != m_current)
+		{
+			ReleaseStatement(m_current);
+			m_current = nullptr;
+		}
+
+		m_query = query;
+
+		// Statement를 할당 받아 바인딩 합니다.
+		m_current = AcquireStatement(m_query);
+		if (nullptr == m_current)
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to acquire a statement.");
+			return false;
+		}
+
+		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, m_query->GetScript());
+		
+		return true;
+	}
+
+	SQLRETURN Execute()
+	{
+		if (nullptr == m_current)
+		{
+			return SQL_ERROR;
+		}
+
+		auto sqlResultCode = Run(m_query, m_current->statement);
+
+		ReleaseStatement(m_current);
+		m_current = nullptr;
+
+		return sqlResultCode;
+	}
+
+	// BindQuery와 별도로 Statement를 할당 받아 실행한다.
+	// 같은 연결에서 다른 쿼리(Cursor, Parse 도중 등)가 열려 있어도 실행할 수 있다. (MARS)
+	SQLRETURN Execute(IQuery* query)
+	{
+		auto lease = AcquireStatement(query);
+		if (nullptr == lease)
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to acquire a statement.");
+			return SQL_ERROR;
+		}
+
+		auto sqlResultCode = Run(query, lease->statement);
+
+		ReleaseStatement(lease);
+
+		return sqlResultCode;
+	}
+
+	// 결과를 호출자가 직접 읽기 위한 커서
+	// 열려 있는 동안 Statement를 점유하며 같은 연결에서 다른 쿼리를 실행할 수 있다. (MARS)
+	// 연결을 풀에 반환하기 전에 닫아야 한다.
+	class Cursor
+	{
+	public:
+		Cursor() = default;
+
+		Cursor(Cursor&& other) noexcept
+			: m_odbc(other.m_odbc)
+			, m_lease(other.m_lease)
+			, m_result(other.m_result)
+		{
+			other.m_lease = nullptr;
+		}
+
+		Cursor& operator=(Cursor&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Close();
+
+				m_odbc = other.m_odbc;
+				m_lease = other.m_lease;
+				m_result = other.m_result;
+				other.m_lease = nullptr;
+			}
+
+			return *this;
+		}
+
+		~Cursor()
+		{
+			Close();
+		}
+
+		inline bool IsOpen() { return (nullptr != m_lease); }
+
+		// 실행 결과 (SQL_NO_DATA일 경우 결과 row 없음)
+		inline SQLRETURN GetResult() { return m_result; }
+
+		inline Statement* GetStatement() { return (nullptr == m_lease) ? nullptr : &m_lease->statement; }
+
+		void Close()
+		{
+			if (nullptr == m_lease)
+			{
+				return;
+			}
+
+			m_odbc->ReleaseStatement(m_lease);
+			m_lease = nullptr;
+		}
+
+	private:
+		friend class Odbc;
+
+		Odbc* m_odbc = nullptr;
+		CachedStatement* m_lease = nullptr;
+		SQLRETURN m_result = SQL_ERROR;
+	};
+
+	// 쿼리를 실행하고 첫 row에 위치한 커서를 반환한다.
+	// 에러는 DAO의 HandleOdbcException으로 전달되며 커서는 닫힌 상태로 반환된다.
+	Cursor OpenCursor(IQuery* query)
+	{
+		Cursor cursor;
+		cursor.m_odbc = this;
+		cursor.m_lease = AcquireStatement(query);
+		if (nullptr == cursor.m_lease)
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to acquire a statement.");
+			return cursor;
+		}
+
+		cursor.m_result = Open(query, cursor.m_lease->statement);
+		if (!(SQL_SUCCESS == cursor.m_result || SQL_NO_DATA == cursor.m_result))
+		{
+			cursor.Close();
+		}
+
+		return cursor;
+	}
+
+	// 비동기 실행 (SQL_ATTR_ASYNC_ENABLE)
+	// Prepare, Execute는 폴링 방식으로 진행되며 실행이 완료되면 결과 레코드셋은 동기로 읽어 DAO에 전달한다.
+	// 실행이 완료되거나 취소될 때까지 Statement를 점유하며 연결을 풀에 반환하기 전에 완료되어야 한다.
+	class AsyncExecution
+	{
+	public:
+		enum class ePhase
+		{
+			Prepare = 0,
+			Execute,
+			Done
+		};
+
+		AsyncExecution() = default;
+
+		AsyncExecution(AsyncExecution&& other) noexcept
+			: m_odbc(other.m_odbc)
+			, m_query(other.m_query)
+			, m_lease(other.m_lease)
+			, m_phase(other.m_phase)
+			, m_issued(other.m_issued)
+			, m_result(other.m_result)
+			, m_error(std::move(other.m_error))
+			, m_sample(other.m_sample)
+		{
+			other.m_lease = nullptr;
+			other.m_phase = ePhase::Done;
+			other.m_issued = false;
+		}
+
+		AsyncExecution& operator=(AsyncExecution&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Cancel();
+
+				m_odbc = other.m_odbc;
+				m_query = other.m_query;
+				m_lease = other.m_lease;
+				m_phase = other.m_phase;
+				m_issued = other.m_issued;
+				m_result = other.m_result;
+				m_error = std::move(other.m_error);
+				m_sample = other.m_sample;
+				other.m_lease = nullptr;
+				other.m_phase = ePhase::Done;
+				other.m_issued = false;
+			}
+
+			return *this;
+		}
+
+		~AsyncExecution()
+		{
+			Cancel();
+		}
+
+		inline bool IsDone() { return (ePhase::Done == m_phase); }
+
+		inline ePhase GetPhase() { return m_phase; }
+
+		// 완료 전에는 SQL_STILL_EXECUTING
+		inline SQLRETURN GetResult() { return m_result; }
+
+		// 이 실행에서 발생한 에러 (없을 경우 nullptr)
+		// 한 연결에서 여러 실행이 겹칠 수 있으므로 Odbc::GetLastError 대신 사용한다.
+		inline _odbc_error_ptr_t GetError() { return m_error; }
+
+		inline IQuery* GetQuery() { return m_query; }
+
+		// 진행 중인 실행을 취소하고 Statement를 반환한다.
+		void Cancel()
+		{
+			if (nullptr == m_lease)
+			{
+				return;
+			}
+
+			m_odbc->CancelAsync(*this);
+		}
+
+	private:
+		friend class Odbc;
+
+		Odbc* m_odbc = nullptr;
+		IQuery* m_query = nullptr;
+		CachedStatement* m_lease = nullptr;
+		ePhase m_phase = ePhase::Done;
+
+		// 현재 단계의 함수가 드라이버에서 실행 중인지 여부 (SQL_STILL_EXECUTING)
+		bool m_issued = false;
+
+		SQLRETURN m_result = SQL_ERROR;
+		_odbc_error_ptr_t m_error;
+		QueryMetrics::Sample m_sample;
+	};
+
+	// 쿼리를 바인딩하고 비동기 실행을 시작한다. 이후 완료될 때까지 Poll을 호출한다.
+	AsyncExecution BeginExecute(IQuery* query)
+	{
+		m_lastError = nullptr;
+
+		AsyncExecution execution;
+		execution.m_odbc = this;
+		execution.m_query = query;
+		execution.m_lease = AcquireStatement(query);
+		if (nullptr == execution.m_lease)
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to acquire a statement.");
+			return execution;
+		}
+
+		// 지원하지 않는 드라이버는 Poll 호출 시 동기로 실행된다.
+		if (false == execution.m_lease->statement.SetAsync(true))
+		{
+			OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, "Asynchronous execution is not supported. It is executed synchronously.");
+		}
+
+		execution.m_result = SQL_STILL_EXECUTING;
+		execution.m_phase = (true == execution.m_lease->statement.IsPrepared()) ? AsyncExecution::ePhase::Execute : AsyncExecution::ePhase::Prepare;
+
+		if (nullptr != m_queryMetrics)
+		{
+			execution.m_sample.Begin(std::exchange(m_checkoutWait, -1));
+			execution.m_lease->statement.ResetReadCount();
+		}
+
+		return execution;
+	}
+
+	// 실행 상태를 확인하여 진행한다. 진행 중이면 SQL_STILL_EXECUTING을 반환하며
+	// 완료되면 DAO의 Parse, Process까지 호출한 후 Execute(IQuery*)와 동일한 결과를 반환한다.
+	SQLRETURN Poll(AsyncExecution& execution)
+	{
+		if (nullptr == execution.m_lease)
+		{
+			return execution.m_result;
+		}
+
+		auto query = execution.m_query;
+		auto& statement = execution.m_lease->statement;
+
+		if (AsyncExecution::ePhase::Prepare == execution.m_phase)
+		{
+			SQLRETURN sqlResultCode = statement.Prepare(query->GetScript());
+			execution.m_issued = (SQL_STILL_EXECUTING == sqlResultCode);
+			if (SQL_STILL_EXECUTING == sqlResultCode)
+			{
+				return sqlResultCode;
+			}
+
+			if (SQL_SUCCESS != sqlResultCode)
+			{
+				auto errorObject = statement.GetError();
+				m_lastError = errorObject;
+				query->GetDao()->HandleOdbcException(errorObject);
+
+				OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
+
+				CompleteAsync(execution, sqlResultCode, errorObject);
+				return sqlResultCode;
+			}
+
+			execution.m_phase = AsyncExecution::ePhase::Execute;
+			execution.m_sample.prepared = std::chrono::steady_clock::now();
+		}
+
+		SQLRETURN sqlResultCode = statement.Execute();
+		execution.m_issued = (SQL_STILL_EXECUTING == sqlResultCode);
+		if (SQL_STILL_EXECUTING == sqlResultCode)
+		{
+			return sqlResultCode;
+		}
+
+		execution.m_sample.executed = std::chrono::steady_clock::now();
+
+		// 결과는 이미 수신된 상태이므로 레코드셋은 동기로 읽는다.
+		statement.SetAsync(false);
+
+		// 같은 연결의 다른 실행이 남긴 에러와 섞이지 않도록 초기화 후 이 실행의 에러만 전달한다.
+		m_lastError = nullptr;
+		sqlResultCode = Consume(query, statement, OpenExecuted(query, statement, sqlResultCode));
+
+		CompleteAsync(execution, sqlResultCode, m_lastError);
+		return sqlResultCode;
+	}
+
+	// 마지막 실행에서 발생한 에러 (없을 경우 nullptr)
+	inline _odbc_error_ptr_t GetLastError() { return m_lastError; }
+
+	_odbc_error_ptr_t GetDbcError()
+	{
+		auto odbcError = std::make_shared<OdbcError>(SQL_HANDLE_DBC, m_hDbc);
+		odbcError->Parse();
+
+		return odbcError;
+	}
+
+private:
+	// 연결마다 환경을 할당하지 않고 프로세스에서 공유하는 환경(OdbcEnvironment)을 참조한다.
+	SQLHENV AllocENV()
+	{
+		// ms. https://docs.microsoft.com/ko-kr/sql/odbc/microsoft-open-database-connectivity-odbc?view=sql-server-2017
+		// ibm. https://www.ibm.com/support/knowledgecenter/ko/SSEPGG_10.5.0/com.ibm.db2.luw.apdv.cli.doc/doc/r0000553.html
+
+		m_environment = OdbcEnvironment::Acquire();
+		if (nullptr == m_environment)
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to allocate an environment.");
+			return nullptr;
+		}
+
+		return m_environment->GetHandle();
+	}
+
+	SQLHDBC AllocDBC(SQLHENV hEnv, const char* connection_string)
+	{
+		SQLHDBC hDbc = nullptr;
+		SQLRETURN retcode = SQL_ERROR;
+
+		// Allocate a connection.
+		retcode = SQLAllocHandle(SQL_HANDLE_DBC, hEnv, &hDbc);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to allocate a DBC.");
+			return nullptr;
+		}
+
+		// connection attribute setting.
+		retcode = SQLSetConnectAttr(hDbc, SQL_LOGIN_TIMEOUT, reinterpret_cast<SQLPOINTER>(1), 0);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_LOGIN_TIMEOUT.");
+			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
+			return nullptr;
+		}
+
+		retcode = SQLSetConnectAttr(hDbc, SQL_ATTR_CONNECTION_TIMEOUT, reinterpret_cast<SQLPOINTER>(1), 0);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_ATTR_CONNECTION_TIMEOUT.");
+			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
+			return nullptr;
+		}
+
+		retcode = SQLSetConnectAttr(hDbc, SQL_ATTR_AUTOCOMMIT, reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_ON), SQL_IS_UINTEGER);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_ATTR_AUTOCOMMIT.");
+
+			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
+			return nullptr;
+		}
+#ifdef SQL_COPT_SS_MARS_ENABLED
+		retcode = SQLSetConnectAttr(hDbc, SQL_COPT_SS_MARS_ENABLED, reinterpret_cast<SQLPOINTER>(SQL_MARS_ENABLED_YES), SQL_IS_UINTEGER);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_COPT_SS_MARS_ENABLED.");
+
+			SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
+			return nullptr;
+		}
+#endif
+
+		SQLCHAR* ODBC_ConnectionString = (SQLCHAR*)connection_string;
+		SQLCHAR         buffer[1024] = { 0x00, };
+		SQLSMALLINT     outlen = 0;
+
+		// https://docs.microsoft.com/ko-kr/sql/odbc/reference/syntax/sqldriverconnect-function?view=sql-server-ver15
+		// Connect to the driver.  Use the connection string if supplied on the input, otherwise let the driver manager prompt for input.
+		retcode = SQLDriverConnect(hDbc, nullptr, ODBC_ConnectionString, SQL_NTS, buffer, static_cast<SQLSMALLINT>(255), &outlen, SQL_DRIVER_NOPROMPT);
+		if (retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO)
+		{
+			return hDbc;
+		}
+
+		// 		int32_t retry_count = RETRY_COUNT;
+		// 		retcode = SQLGetConnectAttr(hDbc, SQL_COPT_SS_CONNECT_RETRY_COUNT, &retry_count, SQL_IS_INTEGER, NULL);
+		// 		retcode = SQLGetConnectAttr(hDbc, SQL_COPT_SS_CONNECT_RETRY_INTERVAL, &retry_count, SQL_IS_INTEGER, NULL);
+
+		auto dbcError = GetDbcError();
+		OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, dbcError->ToString());
+
+		SQLFreeHandle(SQL_HANDLE_STMT, hDbc);
+		return nullptr;
+	}
+
+	// Prepare(캐시되지 않은 경우), Execute 후 첫 row를 읽는다.
+	// sample이 있으면 단계별 완료 시각을 기록한다.
+	SQLRETURN Open(IQuery* query, Statement& statement, QueryMetrics::Sample* sample = nullptr)
+	{
+		SQLRETURN sqlResultCode = SQL_SUCCESS;
+
+		m_lastError = nullptr;
+
+		// 캐시된 Statement는 이미 준비되어 있으므로 Prepare를 생략한다.
+		if (false == statement.IsPrepared())
+		{
+			sqlResultCode = statement.Prepare(query->GetScript());
+		}
+
+		if (nullptr != sample)
+		{
+			sample->prepared = std::chrono::steady_clock::now();
+		}
+
+		if (SQL_SUCCESS != sqlResultCode)
+		{
+			auto errorObject = statement.GetError();
+			m_lastError = errorObject;
+			query->GetDao()->HandleOdbcException(errorObject);
+
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
+
+			return sqlResultCode;
+		}
+
+		sqlResultCode = statement.Execute();
+
+		if (nullptr != sample)
+		{
+			sample->executed = std::chrono::steady_clock::now();
+		}
+
+		return OpenExecuted(query, statement, sqlResultCode);
+	}
+
+	// Execute 결과를 확인하고 첫 row를 읽는다.
+	SQLRETURN OpenExecuted(IQuery* query, Statement& statement, SQLRETURN sqlResultCode)
+	{
+		// 파라미터 배열 실행은 일부 셋이 실패할 경우 SQL_SUCCESS_WITH_INFO를 반환하며 결과는 셋별 상태로 확인한다.
+		if (SQL_SUCCESS_WITH_INFO == sqlResultCode && 1 < statement.GetParamSetSize())
+		{
+			auto errorObject = statement.GetError();
+			query->GetDao()->HandleOdbcException(errorObject);
+
+			OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, errorObject->ToString());
+
+			sqlResultCode = SQL_SUCCESS;
+		}
+
+		if (SQL_SUCCESS != sqlResultCode)
+		{
+			// 풀에 반환되지 않도록 처리되어야하며 로직에 현재 상황이 보고되어야 한다.
+			auto errorObject = statement.GetError();
+			m_lastError = errorObject;
+			query->GetDao()->HandleOdbcException(errorObject);
+
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
+
+			return sqlResultCode;
+		}
+
+		sqlResultCode = statement.Fetch();
+		if (SQL_SUCCESS != sqlResultCode)
+		{
+			// 풀에 반환되지 않도록 처리되어야하며 로직에 현재 상황이 보고되어야 한다.
+			if (SQL_NO_DATA != sqlResultCode)
+			{
+				auto errorObject = statement.GetError();
+				m_lastError = errorObject;
+				query->GetDao()->HandleOdbcException(errorObject);
+
+				OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, errorObject->ToString());
+			}
+		}
+
+		return sqlResultCode;
+	}
+
+	SQLRETURN Run(IQuery* query, Statement& statement)
+	{
+		if (nullptr == m_queryMetrics)
+		{
+			return Consume(query, statement, Open(query, statement));
+		}
+
+		QueryMetrics::Sample sample;
+		sample.Begin(std::exchange(m_checkoutWait, -1));
+		statement.ResetReadCount();
+
+		auto sqlResultCode = Consume(query, statement, Open(query, statement, &sample));
+
+		RecordSample(query, statement, sample, sqlResultCode);
+
+		return sqlResultCode;
+	}
+
+	void RecordSample(IQuery* query, Statement& statement, const QueryMetrics::Sample& sample, SQLRETURN sqlResultCode)
+	{
+		bool success = (SQL_SUCCESS == sqlResultCode || SQL_SUCCESS_WITH_INFO == sqlResultCode || SQL_NO_DATA == sqlResultCode);
+		m_queryMetrics->Record(query->GetScript(), sample, success, statement.GetReadRowCount(), statement.GetReadByteCount());
+	}
+
+	// 실행 중 DAO와 Statement가 실행 단위 arena를 사용하도록 설정한다.
+	class ArenaScope
+	{
+	public:
+		ArenaScope(ExecutionArena* arena, IDataAccessObject* dao, Statement& statement)
+			: m_arena(arena), m_dao(dao), m_statement(statement)
+		{
+			if (nullptr == m_arena)
+			{
+				return;
+			}
+
+			m_arena->Enter();
+			m_dao->SetMemoryResource(m_arena->GetResource());
+			m_statement.SetMemoryResource(m_arena->GetResource());
+		}
+
+		~ArenaScope()
+		{
+			if (nullptr == m_arena)
+			{
+				return;
+			}
+
+			m_dao->SetMemoryResource(nullptr);
+			m_statement.SetMemoryResource(nullptr);
+			m_arena->Leave();
+		}
+
+	private:
+		ExecutionArena* m_arena;
+		IDataAccessObject* m_dao;
+		Statement& m_statement;
+	};
+
+	// 열린 레코드셋을 순서대로 DAO에 전달한 후 결과 처리를 호출한다.
+	SQLRETURN Consume(IQuery* query, Statement& statement, SQLRETURN sqlResultCode)
+	{
+		// SQL_NO_DATA는 첫 레코드셋이 비어 있거나 결과 컬럼이 없는 경우(INSERT 등)이므로 다음 레코드셋을 확인한다.
+		if (SQL_SUCCESS != sqlResultCode && SQL_NO_DATA != sqlResultCode)
+		{
+			return sqlResultCode;
+		}
+
+		// Parse ~ Process 동안 할당된 메모리는 실행이 끝나면 한번에 해제된다.
+		ArenaScope arenaScope(m_arena.get(), query->GetDao(), statement);
+
+		try
+		{
+			do
+			{
+				if (true == statement.IsNoData())
+				{
+					// 해당 레코드셋에 데이터가 없을 경우 다음 레코드셋으로 이동합니다.
+					continue;
+				}
+
+				if (false == query->GetDao()->Parse(&statement))
+				{
+					// Todo: 예외발생하였으며 후 처리가 필요하다.
+					// 연결의 문제가 아닌 로직의 문제이기 때문에 break 후 SQL_SUCCESS를 반환한다.
+					break;
+				}
+			} while (true == statement.MoveNextRecordSet());
+
+			// 레코드셋 파싱이 끝난 시점에 결과 처리를 할수 있도록 Result 메서드를 호출 한다.
+			query->GetDao()->Process();
+
+		}
+		catch (StatementException& e)
+		{
+			// 크리티컬일 경우 에러를 반환한다.
+			m_lastError = e.GetNative();
+
+			if (true == e.GetNative()->IsCritical())
+			{
+				return SQL_ERROR;
+			}
+
+			query->GetDao()->HandleOdbcException(e.GetNative());
+
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, e.GetNative()->ToString());
+
+			// 읽는 도중 교착 상태로 롤백되면 결과가 완전하지 않으므로 실패를 반환한다. (재시도 대상)
+			if (OdbcError::eErrorClass::Deadlock == e.GetNative()->GetErrorClass())
+			{
+				return SQL_ERROR;
+			}
+		}
+
+		OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, "Completed.");
+
+		return SQL_SUCCESS;
+	}
+
+	void CompleteAsync(AsyncExecution& execution, SQLRETURN sqlResultCode, _odbc_error_ptr_t error)
+	{
+		execution.m_result = sqlResultCode;
+		execution.m_error = std::move(error);
+		execution.m_phase = AsyncExecution::ePhase::Done;
+
+		if (nullptr != m_queryMetrics)
+		{
+			RecordSample(execution.m_query, execution.m_lease->statement, execution.m_sample, sqlResultCode);
+		}
+
+		ReleaseStatement(execution.m_lease);
+		execution.m_lease = nullptr;
+	}
+
+	// 취소 요청 후 실행 중인 함수를 다시 호출하여 완료를 확인한다. (HY008)
+	// Poll 전이라 드라이버에 요청하지 않은 경우 실행하지 않고 Statement만 반환한다.
+	void CancelAsync(AsyncExecution& execution)
+	{
+		auto& statement = execution.m_lease->statement;
+
+		if (true == execution.m_issued && AsyncExecution::ePhase::Done != execution.m_phase && true == statement.IsAsync())
+		{
+			statement.Cancel();
+
+			SQLRETURN sqlResultCode = SQL_STILL_EXECUTING;
+			for (int32_t waitCount = 0; SQL_STILL_EXECUTING == sqlResultCode; )
+			{
+				sqlResultCode = (AsyncExecution::ePhase::Prepare == execution.m_phase) ? statement.Prepare(execution.m_query->GetScript()) : statement.Execute();
+				if (SQL_STILL_EXECUTING == sqlResultCode)
+				{
+					Statement::WaitStillExecuting(waitCount);
+				}
+			}
+		}
+
+		execution.m_issued = false;
+
+		CompleteAsync(execution, SQL_ERROR, nullptr);
+	}
+
+	// Statement를 할당 받아 쿼리를 바인딩한다.
+	CachedStatement* AcquireStatement(IQuery* query)
+	{
+		auto lease = AcquireStatement(query->GetScript());
+		if (nullptr == lease)
+		{
+			return nullptr;
+		}
+
+		lease->statement.SetRowArraySize(query->GetRowArraySize());
+
+		// 바인딩 합니다.
+		if (false == query->Build(&lease->statement))
+		{
+			ReleaseStatement(lease);
+			return nullptr;
+		}
+
+		return lease;
+	}
+
+	// 스크립트로 준비된 유휴 Statement를 찾는다.
+	// 없을 경우 새로 할당하거나 가장 오래 사용되지 않은 유휴 Statement를 재사용한다.
+	// 모든 Statement가 사용 중이며 최대 수에 도달한 경우 nullptr을 반환한다.
+	CachedStatement* AcquireStatement(const char* script)
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		auto range = m_statementIndex.equal_range(script);
+		for (auto itr = range.first; itr != range.second; ++itr)
+		{
+			if (false == itr->second->used)
+			{
+				++m_statementCacheStats.hit;
+				return Lease(itr->second);
+			}
+		}
+
+		++m_statementCacheStats.miss;
+
+		CachedStatement* cached = nullptr;
+		if (m_statementCache.size() < GetStatementCacheLimit())
+		{
+			cached = NewStatement();
+		}
+
+		if (nullptr == cached)
+		{
+			cached = FindIdleStatement();
+			if (nullptr != cached)
+			{
+				if (false == cached->script.empty())
+				{
+					++m_statementCacheStats.eviction;
+				}
+
+				cached->statement.Unprepare();
+			}
+		}
+
+		// 모두 사용 중일 경우 최대 수까지 추가로 할당한다.
+		if (nullptr == cached)
+		{
+			cached = NewStatement();
+		}
+
+		if (nullptr == cached)
+		{
+			return nullptr;
+		}
+
+		Rekey(cached, script);
+
+		return Lease(cached);
+	}
+
+	void ReleaseStatement(CachedStatement* cached)
+	{
+		cached->statement.Close();
+
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		cached->used = false;
+
+		if (0 == m_statementCacheCapacity)
+		{
+			Rekey(cached, "");
+			cached->statement.Unprepare();
+		}
+
+		TrimStatementCache();
+	}
+
+	inline size_t GetStatementCacheLimit() { return (std::max)(m_statementCacheCapacity, static_cast<size_t>(1)); }
+
+	CachedStatement* Lease(CachedStatement* cached)
+	{
+		cached->used = true;
+
+		// 최근 사용으로 이동
+		m_statementCache.splice(m_statementCache.begin(), m_statementCache, cached->self);
+
+		return cached;
+	}
+
+	// 연결에서 동시에 열 수 있는 수(m_maxStatementCount)를 넘지 않도록 모든 할당은 여기서 확인한다.
+	CachedStatement* NewStatement()
+	{
+		if (m_maxStatementCount <= m_statementCache.size())
+		{
+			return nullptr;
+		}
+
+		auto hStmt = AllocSTMT(m_hDbc);
+		if (nullptr == hStmt)
+		{
+			return nullptr;
+		}
+
+		auto& cached = m_statementCache.emplace_front();
+		cached.self = m_statementCache.begin();
+		cached.statement.Open(hStmt);
+
+		if (0 != m_queryTimeout && false == cached.statement.SetQueryTimeout(m_queryTimeout))
+		{
+			OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, "Failed to set an attribute that is SQL_ATTR_QUERY_TIMEOUT.");
+		}
+
+		return &cached;
+	}
+
+	// 가장 오래 사용되지 않은 유휴 Statement
+	CachedStatement* FindIdleStatement()
+	{
+		for (auto itr = m_statementCache.rbegin(); itr != m_statementCache.rend(); ++itr)
+		{
+			if (false == itr->used)
+			{
+				return &(*itr);
+			}
+		}
+
+		return nullptr;
+	}
+
+	// 스크립트 인덱스를 변경한다.
+	void Rekey(CachedStatement* cached, std::string_view script)
+	{
+		auto range = m_statementIndex.equal_range(cached->script);
+		for (auto itr = range.first; itr != range.second; ++itr)
+		{
+			if (cached == itr->second)
+			{
+				m_statementIndex.erase(itr);
+				break;
+			}
+		}
+
+		cached->script = script;
+
+		if (false == cached->script.empty())
+		{
+			m_statementIndex.emplace(cached->script, cached);
+		}
+	}
+
+	// 캐시 크기를 넘는 유휴 Statement를 오래된 순서로 해제한다.
+	void TrimStatementCache()
+	{
+		while (GetStatementCacheLimit() < m_statementCache.size())
+		{
+			auto cached = FindIdleStatement();
+			if (nullptr == cached)
+			{
+				break;
+			}
+
+			if (false == cached->script.empty())
+			{
+				++m_statementCacheStats.eviction;
+			}
+
+			Rekey(cached, "");
+			cached->statement.Destroy();
+			m_statementCache.erase(cached->self);
+		}
+	}
+
+	void ClearStatementCache()
+	{
+		std::lock_guard<std::mutex> lock(m_statementMutex);
+
+		m_current = nullptr;
+		m_statementIndex.clear();
+
+		for (auto& cached : m_statementCache)
+		{
+			cached.statement.Destroy();
+		}
+
+		m_statementCache.clear();
+	}
+
+	SQLHSTMT AllocSTMT(SQLHDBC hDbc)
+	{
+		SQLHSTMT hStmt;
+		SQLRETURN retcode = SQL_ERROR;
+
+		// Allocate a Statement.
+		retcode = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+		if (!(retcode == SQL_SUCCESS || retcode == SQL_SUCCESS_WITH_INFO))
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "Failed to allocate a handle that is SQL_HANDLE_STMT.");
+			return nullptr;
+		}
+
+		return hStmt;
+	}
+
+	template <ILogging::eLevel level, typename... Args>
+	void OnLog(const char* function, int32_t line, std::string_view format, Args... args)
+	{
+		if (nullptr == m_logging)
+		{
+			return;
+		}
+
+		std::stringstream ss;
+		ss << "[" << NamedLoggingLevel<level>::Name() << "][" << function << "(" << line << ")][" << format << "]";
+		
+		std::string message = ss.str();
+
+		switch (level)
+		{
+		case ILogging::eLevel::Trace:
+			m_logging->Trace(message);
+			break;
+		case ILogging::eLevel::Debug:
+			m_logging->Debug(message);
+			break;
+		case ILogging::eLevel::Info:
+			m_logging->Info(message);
+			break;
+		case ILogging::eLevel::Warning:
+			m_logging->Warning(message);
+			break;
+		case ILogging::eLevel::Error:
+			m_logging->Error(message);
+			break;
+		default:
+			break;
+		}
+	}
+
+	std::atomic<eState> m_state = eState::None;
+
+	SQLHENV m_hEnv = SQL_NULL_HENV;
+	SQLHDBC m_hDbc = SQL_NULL_HDBC;
+	std::shared_ptr<OdbcEnvironment> m_environment;
+
+	// 연결에 할당된 Statement (LRU, 앞쪽이 최근 사용)
+	// 스크립트로 준비된 유휴 Statement는 재사용되며 사용 중인 Statement는 다른 쿼리에 할당되지 않는다.
+	struct CachedStatement
+	{
+		std::string script;
+		Statement statement;
+		bool used = false;
+		std::list<CachedStatement>::iterator self;
+	};
+
+	std::mutex m_statementMutex;
+	std::list<CachedStatement> m_statementCache;
+	std::unordered_multimap<std::string_view, CachedStatement*> m_statementIndex;
+	size_t m_statementCacheCapacity = 0;
+	size_t m_maxStatementCount = 1;
+	SQLULEN m_queryTimeout = 0;
+	StatementCacheStats m_statementCacheStats;
+
+	// BindQuery로 바인딩된 쿼리가 사용하는 Statement
+	CachedStatement* m_current = nullptr;
+
+	IQuery* m_query = nullptr;
+
+	// 아래 상태는 잠금 없이 사용되므로 하나의 Odbc는 한 쓰레드에서만 사용해야 한다. (풀에서 받은 쓰레드)
+	// 같은 쓰레드에서 여러 Statement(MARS)를 번갈아 사용하는 것은 허용된다.
+	// - m_lastError: 마지막으로 끝난 동기 실행의 에러. 비동기 실행은 AsyncExecution::GetError를 사용한다.
+	// - m_checkoutWait: 체크아웃 이후 처음 시작된 실행 하나에만 기록된다.
+	// - m_arena: 중첩 실행은 깊이로 관리되어 모두 끝났을 때 해제된다.
+	_odbc_error_ptr_t m_lastError;
+
+	uint64_t m_generation = 0;
+	std::chrono::steady_clock::time_point m_connectedTime;
+
+	std::shared_ptr<QueryMetrics> m_queryMetrics;
+	int64_t m_checkoutWait = -1;
+
+	// 실행 단위 arena
+	std::unique_ptr<ExecutionArena> m_arena;
+	_logging_ptr_t m_logging;
+};
+
+// 공통 인터페이스
+template <typename Element>
+class IQueue
+{
+public:
+	using _element_t = Element;
+
+	virtual bool TryPop(_element_t& task) = 0;
+	virtual void Put(_element_t&& task) = 0;
 };
 
 class NonThreadSafeQueue : public IQueue<std::shared_ptr<Odbc>>
 {
 public:
-	virtual bool TryPop(_element_t& task) override
+	virtual bool TryPop(_element_t& task) override
+	{
+		if (true == m_stack.empty())
+		{
+			return false;
+		}
+
+		task = m_stack.back();
+		m_stack.pop_back();
+
+		return true;
+	}
+
+	virtual void Put(_element_t&& task) override 
+	{
+		m_stack.push_back(std::forward<_element_t>(task));
+	}
+
+private:
+	std::deque<_element_t> m_stack; // 스택으로 사용함.
+};
+
+// 여러 쓰레드가 하나의 OdbcPool을 공유할 때 사용하는 lock-free 스택 (Treiber stack)
+// 노드는 인덱스로 가리키며 top에 변경 횟수(tag)를 함께 두어 CAS 시 ABA 문제를 막는다.
+// 꺼낸 노드는 해제하지 않고 빈 노드 스택으로 옮겨 재사용하므로 다른 쓰레드가 읽는 중인 노드가 해제되지 않는다.
+class ThreadSafeQueue : public IQueue<std::shared_ptr<Odbc>>
+{
+public:
+	ThreadSafeQueue()
+		: m_segments(new std::atomic<Node*>[MAX_SEGMENT_COUNT])
+	{
+		for (size_t i = 0; i < MAX_SEGMENT_COUNT; ++i)
+		{
+			m_segments[i].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	~ThreadSafeQueue()
+	{
+		for (size_t i = 0; i < MAX_SEGMENT_COUNT; ++i)
+		{
+			delete[] m_segments[i].load(std::memory_order_relaxed);
+		}
+	}
+
+	ThreadSafeQueue(const ThreadSafeQueue&) = delete;
+	ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
+
+	virtual bool TryPop(_element_t& task) override
+	{
+		uint32_t index = Pop(m_top);
+		if (NIL == index)
+		{
+			return false;
+		}
+
+		auto& node = GetNode(index);
+		task = std::move(node.value);
+
+		Push(m_free, index);
+
+		return true;
+	}
+
+	virtual void Put(_element_t&& task) override
+	{
+		uint32_t index = Pop(m_free);
+		if (NIL == index)
+		{
+			index = Allocate();
+		}
+
+		// 빈 노드 스택에서 꺼낸 노드는 다른 쓰레드가 값을 읽지 않는다.
+		GetNode(index).value = std::forward<_element_t>(task);
+
+		Push(m_top, index);
+	}
+
+private:
+	static constexpr uint32_t NIL = 0xFFFFFFFF;
+	static constexpr size_t SEGMENT_SIZE = 256;
+	static constexpr size_t MAX_SEGMENT_COUNT = 4096;
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	struct Node
+	{
+		_element_t value;
+		std::atomic<uint32_t> next = NIL;
+	};
+
+	// 상위 32bit : tag, 하위 32bit : 노드 인덱스
+	static inline uint64_t MakeHead(uint64_t tag, uint32_t index) { return (tag << 32) | index; }
+	static inline uint32_t GetIndex(uint64_t head) { return static_cast<uint32_t>(head); }
+	static inline uint64_t GetTag(uint64_t head) { return (head >> 32); }
+
+	inline Node& GetNode(uint32_t index)
+	{
+		return m_segments[index / SEGMENT_SIZE].load(std::memory_order_acquire)[index % SEGMENT_SIZE];
+	}
+
+	void Push(std::atomic<uint64_t>& top, uint32_t index)
+	{
+		auto& node = GetNode(index);
+
+		uint64_t head = top.load(std::memory_order_relaxed);
+		do
+		{
+			node.next.store(GetIndex(head), std::memory_order_relaxed);
+		} while (false == top.compare_exchange_weak(head, MakeHead(GetTag(head) + 1, index), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	uint32_t Pop(std::atomic<uint64_t>& top)
+	{
+		uint64_t head = top.load(std::memory_order_acquire);
+		while (NIL != GetIndex(head))
+		{
+			// 다른 쓰레드가 먼저 꺼내 next가 바뀌었다면 tag가 달라 CAS가 실패한다.
+			uint32_t next = GetNode(GetIndex(head)).next.load(std::memory_order_relaxed);
+			if (true == top.compare_exchange_weak(head, MakeHead(GetTag(head) + 1, next), std::memory_order_acquire, std::memory_order_acquire))
+			{
+				return GetIndex(head);
+			}
+		}
+
+		return NIL;
+	}
+
+	// 새 노드를 할당한다. 노드는 구간(segment) 단위로 생성되어 소멸 시까지 유지된다.
+	uint32_t Allocate()
+	{
+		size_t index = m_nodeCount.fetch_add(1, std::memory_order_relaxed);
+		if (SEGMENT_SIZE * MAX_SEGMENT_COUNT <= index)
+		{
+			// 동시에 보관 가능한 연결 수를 넘은 경우로 설정(maxOdbcCount)을 확인해야 한다.
+			std::abort();
+		}
+
+		auto& segment = m_segments[index / SEGMENT_SIZE];
+		if (nullptr == segment.load(std::memory_order_acquire))
+		{
+			Node* created = new Node[SEGMENT_SIZE];
+			Node* expected = nullptr;
+			if (false == segment.compare_exchange_strong(expected, created, std::memory_order_acq_rel))
+			{
+				delete[] created;
+			}
+		}
+
+		return static_cast<uint32_t>(index);
+	}
+
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_top = MakeHead(0, NIL);
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_free = MakeHead(0, NIL);
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_nodeCount = 0;
+	std::unique_ptr<std::atomic<Node*>[]> m_segments;
+};
+
+// OdbcPool의 백그라운드 쓰레드가 풀(Queue)에 직접 접근해도 되는지 여부
+template <typename Queue>
+struct IsThreadSafeQueue : std::false_type {};
+
+template <>
+struct IsThreadSafeQueue<ThreadSafeQueue> : std::true_type {};
+
+// 크기가 고정된 lock-free MPMC 큐 (bounded ring buffer)
+// 칸마다 순번(sequence)을 두어 생산자/소비자가 CAS 1회로 위치를 선점한다.
+template <typename T>
+class MpmcQueue
+{
+public:
+	// capacity는 2의 거듭제곱으로 올림된다.
+	explicit MpmcQueue(size_t capacity)
+		: m_mask(RoundUp(capacity) - 1)
+		, m_cells(new Cell[m_mask + 1])
+	{
+		for (size_t i = 0; i <= m_mask; ++i)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+	inline size_t GetCapacity() { return m_mask + 1; }
+
+	// 가득 찬 경우 false를 반환한다.
+	template <typename U>
+	bool TryPut(U&& value)
+	{
+		size_t pos = m_tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			auto& cell = m_cells[pos & m_mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (0 == diff)
+			{
+				if (true == m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.value = std::forward<U>(value);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool TryPop(T& out_value)
+	{
+		return (1 == TryPopBulk(&out_value, 1));
+	}
+
+	// 연속으로 준비된 칸을 최대 count 개까지 한번에 선점하여 꺼낸다.
+	size_t TryPopBulk(T* out_values, size_t count)
+	{
+		size_t pos = m_head.load(std::memory_order_relaxed);
+		while (true)
+		{
+			size_t ready = 0;
+			while (ready < count)
+			{
+				auto& cell = m_cells[(pos + ready) & m_mask];
+				size_t sequence = cell.sequence.load(std::memory_order_acquire);
+				if (sequence != pos + ready + 1)
+				{
+					break;
+				}
+
+				++ready;
+			}
+
+			if (0 == ready)
+			{
+				// 다른 소비자가 먼저 가져간 경우 위치를 갱신하여 다시 확인한다.
+				size_t head = m_head.load(std::memory_order_relaxed);
+				if (head == pos)
+				{
+					return 0;
+				}
+
+				pos = head;
+				continue;
+			}
+
+			if (false == m_head.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed))
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < ready; ++i)
+			{
+				auto& cell = m_cells[(pos + i) & m_mask];
+				out_values[i] = std::move(cell.value);
+				cell.value = T{};
+				cell.sequence.store(pos + i + m_mask + 1, std::memory_order_release);
+			}
+
+			return ready;
+		}
+	}
+
+	// 다른 쓰레드가 동시에 접근하는 경우 근사값
+	bool IsEmpty()
+	{
+		size_t pos = m_head.load(std::memory_order_acquire);
+		return (m_cells[pos & m_mask].sequence.load(std::memory_order_acquire) != pos + 1);
+	}
+
+private:
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	static size_t RoundUp(size_t capacity)
+	{
+		size_t size = 2;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+
+		return size;
+	}
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head = 0;
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail = 0;
+	alignas(CACHE_LINE_SIZE) size_t m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+};
+
+// spin 후 대기(park)하는 쓰레드를 깨우기 위한 이벤트 카운트
+// 대기 전에 PrepareWait로 epoch를 받고 조건을 다시 확인한 후 Wait 하여 깨우기 누락을 막는다.
+// C++20 atomic wait(futex)을 지원하면 사용하며 그렇지 않으면 condition_variable을 사용한다.
+class EventCount
+{
+public:
+	uint32_t PrepareWait()
+	{
+		m_waiters.fetch_add(1, std::memory_order_seq_cst);
+		return m_epoch.load(std::memory_order_seq_cst);
+	}
+
+	inline void CancelWait()
+	{
+		m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+	}
+
+	void Wait(uint32_t epoch)
+	{
+#if defined(__cpp_lib_atomic_wait)
+		m_epoch.wait(epoch, std::memory_order_acquire);
+#else
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this, epoch]() { return (epoch != m_epoch.load(std::memory_order_acquire)); });
+#endif
+		CancelWait();
+	}
+
+	// 대기 중인 쓰레드가 없으면 시스템 호출 없이 반환한다.
+	void Notify(bool all = false)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (0 == m_waiters.load(std::memory_order_seq_cst))
+		{
+			return;
+		}
+
+		m_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+#if defined(__cpp_lib_atomic_wait)
+		if (true == all)
+		{
+			m_epoch.notify_all();
+		}
+		else
+		{
+			m_epoch.notify_one();
+		}
+#else
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+		}
+
+		if (true == all)
+		{
+			m_condition.notify_all();
+		}
+		else
+		{
+			m_condition.notify_one();
+		}
+#endif
+	}
+
+private:
+	std::atomic<uint32_t> m_epoch = 0;
+	std::atomic<uint32_t> m_waiters = 0;
+
+#if !defined(__cpp_lib_atomic_wait)
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+#endif
+};
+
+// 작업 훔치기(work stealing)용 deque (Chase-Lev)
+// 소유 쓰레드만 bottom에 넣고 꺼내며 다른 쓰레드는 top에서 훔쳐간다.
+// 원소는 포인터로만 보관한다. (훔치는 쓰레드가 CAS 전에 값을 미리 읽기 때문)
+template <typename T>
+class WorkStealingDeque
+{
+public:
+	// capacity는 2의 거듭제곱으로 올림된다.
+	explicit WorkStealingDeque(size_t capacity)
+		: m_mask(RoundUp(capacity) - 1)
+		, m_buffer(new std::atomic<T*>[m_mask + 1])
+	{
+	}
+
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	// 소유 쓰레드 전용. 가득 찬 경우 false
+	bool TryPush(T* value)
+	{
+		int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		int64_t top = m_top.load(std::memory_order_acquire);
+		if (static_cast<int64_t>(m_mask) < bottom - top)
+		{
+			return false;
+		}
+
+		m_buffer[bottom & m_mask].store(value, std::memory_order_relaxed);
+		m_bottom.store(bottom + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// 소유 쓰레드 전용. 마지막에 넣은 원소를 꺼낸다.
+	T* TryPop()
+	{
+		int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (bottom < top)
+		{
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T* value = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+		if (bottom == top)
+		{
+			// 마지막 원소는 훔치는 쓰레드와 경쟁한다.
+			if (false == m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				value = nullptr;
+			}
+
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return value;
+	}
+
+	// 다른 쓰레드에서 호출. 가장 먼저 넣은 원소를 가져간다.
+	T* TrySteal()
+	{
+		int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (bottom <= top)
+		{
+			return nullptr;
+		}
+
+		T* value = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+		if (false == m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return nullptr;
+		}
+
+		return value;
+	}
+
+	// 다른 쓰레드가 동시에 접근하는 경우 근사값
+	bool IsEmpty()
+	{
+		return (m_bottom.load(std::memory_order_acquire) <= m_top.load(std::memory_order_acquire));
+	}
+
+private:
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	static size_t RoundUp(size_t capacity)
+	{
+		size_t size = 2;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+
+		return size;
+	}
+
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top = 0;
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom = 0;
+	alignas(CACHE_LINE_SIZE) size_t m_mask;
+	std::unique_ptr<std::atomic<T*>[]> m_buffer;
+};
+
+struct OdbcConfiguration
+{
+	std::string connectionString;
+	int32_t maxOdbcCount = 0;
+
+	// 연결별로 보관할 준비된 Statement 수 (0일 경우 사용 안함)
+	// 연결의 Statement 수는 maxStatementCount를 넘지 않으므로 더 큰 값은 maxStatementCount로 적용된다.
+	int32_t statementCacheCapacity = 8;
+
+	// 연결별로 동시에 열 수 있는 Statement 수 (MARS 사용 시 1보다 크게 설정)
+	int32_t maxStatementCount = 8;
+
+	// 연결별 실행 단위 arena 초기 버퍼 크기 (0일 경우 사용 안함)
+	// DAO가 GetMemoryResource로 할당하는 경우에만 효과가 있으므로 필요한 경우 설정한다. (ex. 64 * 1024)
+	int32_t arenaSize = 0;
+
+	// 드라이버 매니저 연결 풀링(SQL_CP_ONE_PER_HENV) 사용 여부
+	// 공유 환경(OdbcEnvironment)이 생성되기 전에 Initialize 되어야 적용된다.
+	bool useDriverConnectionPooling = false;
+
+	// 미리 연결해 둘 대기 연결 수 (0일 경우 사용 안함)
+	// Initialize에서 병렬로 연결하며 이후 부족해지면 백그라운드에서 채운다.
+	int32_t minIdleCount = 0;
+
+	// 대기 연결 수를 확인하는 주기 (ms)
+	int32_t replenishIntervalMs = 1000;
+
+	// 이 시간 동안 사용되지 않은 대기 연결은 종료한다. (ms, 0일 경우 사용 안함)
+	// 대기 연결 목표 수(minIdleCount 이상)만큼은 유지한다.
+	int32_t idleTimeoutMs = 0;
+
+	// 연결 후 이 시간이 지난 연결은 꺼내거나 반환할 때 종료한다. (ms, 0일 경우 사용 안함)
+	int32_t maxLifetimeMs = 0;
+
+	// 연결을 기다린 요청이 있으면 대기 연결 목표 수를 이 값까지 늘린다. (0일 경우 사용 안함)
+	int32_t maxIdleCount = 0;
+
+	// 연결을 기다린 평균 시간이 이 값 이상일 때만 목표 수를 늘린다. (ms)
+	int32_t growthWaitMs = 0;
+
+	// endpoint 상태를 확인하는 주기 (ms, 0일 경우 사용 안함)
+	int32_t healthCheckIntervalMs = 0;
+
+	// 상태 확인에 사용할 쿼리
+	std::string healthCheckScript = "SELECT 1";
+
+	// 응답 시간이 이 값 이상이면 Degraded (ms)
+	int32_t healthCheckDegradedMs = 500;
+
+	// 연결 문제로 연속 실패한 횟수가 이 값 이상이면 Down (쿼리 자체의 에러는 포함하지 않는다.)
+	int32_t healthCheckFailureCount = 2;
+
+	// 연결 문제가 연속으로 발생한 횟수가 이 값 이상이면 연결 시도를 차단한다. (0일 경우 사용 안함)
+	int32_t circuitBreakerFailureCount = 0;
+
+	// 차단 후 다시 시도를 허용하기까지의 시간 (ms)
+	int32_t circuitBreakerOpenMs = 5000;
+
+	// 차단을 해제하기 전에 허용하는 시험 연결 수
+	int32_t circuitBreakerTrialCount = 1;
+
+	// 요청 대비 허용할 재시도 비율 (%)
+	int32_t retryBudgetPercent = 10;
+
+	// 재시도 예산으로 적립 가능한 최대 재시도 수
+	int32_t retryBudgetCapacity = 10;
+
+	// 쿼리 스크립트별 실행 단계 시간, row, byte 수 기록 여부 (OdbcPool::Monitor::GetSnapshot)
+	bool useQueryMetrics = true;
+};
+
+// 연결 대상(endpoint)별 circuit breaker
+// 연결 문제(Critical 에러, 연결 실패)가 연속으로 발생하면 Open 되어 일정 시간 동안 연결을 시도하지 않고 바로 실패한다.
+// 시간이 지나면 HalfOpen 상태에서 정해진 수의 시도만 허용하며 성공하면 Closed, 실패하면 다시 Open 된다.
+// 여러 OdbcPool(OdbcPoolTls 등)이 공유할 수 있으며 상태가 변경되면 true를 반환하여 호출한 풀이 로그를 남긴다.
+class CircuitBreaker
+{
+public:
+	enum class eState
+	{
+		Closed = 0,
+		Open,
+		HalfOpen
+	};
+
+	explicit CircuitBreaker(const OdbcConfiguration& configuration)
+		: m_failureThreshold((std::max)(1, configuration.circuitBreakerFailureCount))
+		, m_trialCount((std::max)(1, configuration.circuitBreakerTrialCount))
+		, m_openDuration(std::chrono::milliseconds((std::max)(1, configuration.circuitBreakerOpenMs)))
+	{
+	}
+
+	inline eState GetState() { return m_state.load(std::memory_order_acquire); }
+
+	// Open, HalfOpen 상태에서 거절된 요청 수
+	inline uint64_t GetRejectCount() { return m_rejectCount.load(std::memory_order_relaxed); }
+
+	static const char* NamedState(eState state)
+	{
+		switch (state)
+		{
+		case eState::Closed:
+			return "Closed";
+		case eState::Open:
+			return "Open";
+		case eState::HalfOpen:
+			return "HalfOpen";
+		default:
+			return "Unknown";
+		}
+	}
+
+	// 연결을 사용(시도)해도 되는지 확인한다.
+	bool TryAcquire(bool& out_changed)
+	{
+		out_changed = false;
+
+		if (eState::Closed == GetState())
+		{
+			return true;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto now = std::chrono::steady_clock::now();
+		switch (GetState())
+		{
+		case eState::Closed:
+			return true;
+
+		case eState::Open:
+			if (now < m_deadline)
+			{
+				m_rejectCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			// 대기 시간이 지나면 일부 시도만 허용한다.
+			m_state.store(eState::HalfOpen, std::memory_order_release);
+			m_trials = 0;
+			m_deadline = now + m_openDuration;
+			out_changed = true;
+			break;
+
+		case eState::HalfOpen:
+			// 결과가 보고되지 않은 시도가 남아 있더라도 대기 시간이 지나면 다시 허용한다.
+			if (m_deadline <= now)
+			{
+				m_trials = 0;
+				m_deadline = now + m_openDuration;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		if (m_trials < m_trialCount)
+		{
+			++m_trials;
+			return true;
+		}
+
+		m_rejectCount.fetch_add(1, std::memory_order_relaxed);
+
+		return false;
+	}
+
+	bool OnSuccess()
+	{
+		if (0 != m_consecutiveFailure.load(std::memory_order_relaxed))
+		{
+			m_consecutiveFailure.store(0, std::memory_order_relaxed);
+		}
+
+		if (eState::Closed == GetState())
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Open 이전에 시작된 요청의 결과는 무시한다.
+		if (eState::HalfOpen != GetState())
+		{
+			return false;
+		}
+
+		m_state.store(eState::Closed, std::memory_order_release);
+
+		return true;
+	}
+
+	bool OnFailure()
+	{
+		if (eState::Closed == GetState() && m_consecutiveFailure.fetch_add(1, std::memory_order_relaxed) + 1 < m_failureThreshold)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		switch (GetState())
+		{
+		case eState::Closed:
+			if (m_consecutiveFailure.load(std::memory_order_relaxed) < m_failureThreshold)
+			{
+				return false;
+			}
+			break;
+
+		case eState::HalfOpen:
+			break;
+
+		default:
+			return false;
+		}
+
+		m_state.store(eState::Open, std::memory_order_release);
+		m_consecutiveFailure.store(0, std::memory_order_relaxed);
+		m_deadline = std::chrono::steady_clock::now() + m_openDuration;
+
+		return true;
+	}
+
+private:
+	const int32_t m_failureThreshold;
+	const int32_t m_trialCount;
+	const std::chrono::milliseconds m_openDuration;
+
+	std::atomic<eState> m_state = eState::Closed;
+	std::atomic<int32_t> m_consecutiveFailure = 0;
+	std::atomic<uint64_t> m_rejectCount = 0;
+
+	std::mutex m_mutex;
+	std::chrono::steady_clock::time_point m_deadline;
+	int32_t m_trials = 0;
+};
+
+// 연결 대상(endpoint)의 상태를 백그라운드에서 확인한다.
+// 전용 연결로 주기마다 가벼운 쿼리(healthCheckScript)를 실행하여 상태와 응답 시간(RTT)을 갱신한다.
+// 여러 OdbcPool(OdbcPoolTls 등)이 공유할 수 있으며 Down 상태에서는 GetConnection이 연결을 시도하지 않고 바로 실패한다.
+class EndpointHealthChecker
+{
+public:
+	enum class eState
+	{
+		Up = 0,
+		Degraded,	// 응답이 느리거나 실패가 누적되는 중
+		Down
+	};
+
+	~EndpointHealthChecker()
+	{
+		Stop();
+	}
+
+	// 확인 쓰레드가 실행 중에도 호출할 수 있다.
+	void AttachLogging(_logging_ptr_t& logging)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_logging = logging;
+	}
+
+	inline bool HasLogging()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return (nullptr != m_logging);
+	}
+
+	inline eState GetState() { return m_state.load(std::memory_order_relaxed); }
+	inline bool IsDown() { return (eState::Down == GetState()); }
+
+	// 마지막으로 성공한 확인의 응답 시간
+	inline std::chrono::microseconds GetLastRtt() { return std::chrono::microseconds(m_lastRtt.load(std::memory_order_relaxed)); }
+
+	inline uint64_t GetProbeCount() { return m_probeCount.load(std::memory_order_relaxed); }
+	inline uint64_t GetFailureCount() { return m_failureCount.load(std::memory_order_relaxed); }
+
+	bool Start(const OdbcConfiguration& configuration)
+	{
+		if (0 >= configuration.healthCheckIntervalMs)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (true == m_isRun)
+		{
+			return false;
+		}
+
+		m_configuration = configuration;
+		m_isRun = true;
+		m_thread = std::thread([this]() { Loop(); });
+
+		return true;
+	}
+
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isRun = false;
+		}
+
+		m_condition.notify_all();
+
+		if (true == m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+
+private:
+	enum class eProbeResult
+	{
+		Success = 0,
+		Failure,	// 연결 실패, 연결 문제(08xxx), 응답 없음(timeout)
+		Error		// 스크립트 에러 등 endpoint와 무관한 실패 (상태를 변경하지 않는다.)
+	};
+
+	class ProbeDao : public IDataAccessObject
+	{
+	public:
+		virtual void HandleOdbcException(_odbc_error_ptr_t& /*err*/) override {}
+		virtual bool Parse(Statement* /*statement*/) override { return true; }
+		virtual void Process() override {}
+	};
+
+	void Loop()
+	{
+		auto interval = std::chrono::milliseconds(m_configuration.healthCheckIntervalMs);
+		Query<ProbeDao> query(m_configuration.healthCheckScript);
+		std::unique_ptr<Odbc> odbc;
+
+		while (true)
+		{
+			auto begin = std::chrono::steady_clock::now();
+			auto result = Probe(odbc, query);
+			auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+			if (eProbeResult::Error != result)
+			{
+				Update(eProbeResult::Success == result, rtt);
+			}
+			else
+			{
+				m_probeCount.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait_for(lock, interval, [this]() { return (false == m_isRun); });
+
+			if (false == m_isRun)
+			{
+				break;
+			}
+		}
+
+		if (nullptr != odbc)
+		{
+			odbc->CleanUp();
+		}
+	}
+
+	// 연결이 없으면 새로 연결한 후 쿼리를 실행한다. 실패한 연결은 다음 확인에서 다시 연결한다.
+	// 연결은 AllocDBC의 로그인 제한 시간(1초)을, 쿼리는 확인 주기만큼의 제한 시간을 사용하므로 Stop이 오래 막히지 않는다.
+	eProbeResult Probe(std::unique_ptr<Odbc>& odbc, Query<ProbeDao>& query)
+	{
+		if (nullptr == odbc)
+		{
+			_logging_ptr_t logging;
+			odbc.reset(new Odbc);
+			odbc->SetStatementCacheCapacity(1);
+			odbc->SetMaxStatementCount(1);
+			odbc->SetQueryTimeout(static_cast<SQLULEN>((std::max)(1, m_configuration.healthCheckIntervalMs / 1000)));
+
+			if (false == odbc->Setup(m_configuration.connectionString.c_str(), logging))
+			{
+				odbc->CleanUp();
+				odbc.reset();
+				return eProbeResult::Failure;
+			}
+		}
+
+		if (SQL_SUCCESS == odbc->Execute(&query))
+		{
+			return eProbeResult::Success;
+		}
+
+		auto error = odbc->GetLastError();
+		if (nullptr != error && false == error->IsCritical() && OdbcError::eErrorClass::Timeout != error->GetErrorClass())
+		{
+			OnLog<ILogging::eLevel::Error>(__FUNCTION__, __LINE__, "The health check query failed. " + error->ToString());
+			return eProbeResult::Error;
+		}
+
+		odbc->CleanUp();
+		odbc.reset();
+		return eProbeResult::Failure;
+	}
+
+	void Update(bool success, std::chrono::microseconds rtt)
+	{
+		m_probeCount.fetch_add(1, std::memory_order_relaxed);
+
+		eState state = eState::Up;
+		if (true == success)
+		{
+			m_consecutiveFailure = 0;
+			m_lastRtt.store(rtt.count(), std::memory_order_relaxed);
+
+			if (std::chrono::milliseconds(m_configuration.healthCheckDegradedMs) <= rtt)
+			{
+				state = eState::Degraded;
+			}
+		}
+		else
+		{
+			m_failureCount.fetch_add(1, std::memory_order_relaxed);
+
+			++m_consecutiveFailure;
+			state = ((std::max)(1, m_configuration.healthCheckFailureCount) <= m_consecutiveFailure) ? eState::Down : eState::Degraded;
+		}
+
+		eState prev = m_state.exchange(state, std::memory_order_relaxed);
+		if (prev == state)
+		{
+			return;
+		}
+
+		std::stringstream ss;
+		ss << "The endpoint state is changed. (" << NamedState(prev) << " -> " << NamedState(state) << ", rtt " << rtt.count() << "us)";
+
+		if (eState::Up == state)
+		{
+			OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, ss.str());
+		}
+		else
+		{
+			OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, ss.str());
+		}
+	}
+
+	static const char* NamedState(eState state)
+	{
+		switch (state)
+		{
+		case eState::Up:
+			return "Up";
+		case eState::Degraded:
+			return "Degraded";
+		case eState::Down:
+			return "Down";
+		default:
+			return "Unknown";
+		}
+	}
+
+	template <ILogging::eLevel level>
+	void OnLog(const char* function, int32_t line, std::string_view format)
+	{
+		_logging_ptr_t logging;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			logging = m_logging;
+		}
+
+		if (nullptr == logging)
+		{
+			return;
+		}
+
+		std::stringstream ss;
+		ss << "[" << NamedLoggingLevel<level>::Name() << "][" << function << "(" << line << ")][" << format << "]";
+
+		switch (level)
+		{
+		case ILogging::eLevel::Info:
+			logging->Info(ss.str());
+			break;
+		case ILogging::eLevel::Warning:
+			logging->Warning(ss.str());
+			break;
+		case ILogging::eLevel::Error:
+			logging->Error(ss.str());
+			break;
+		default:
+			break;
+		}
+	}
+
+	OdbcConfiguration m_configuration;
+	_logging_ptr_t m_logging;
+
+	// 첫 확인 전에는 요청을 막지 않도록 Up으로 시작한다.
+	std::atomic<eState> m_state = eState::Up;
+	std::atomic<int64_t> m_lastRtt = 0;
+	std::atomic<uint64_t> m_probeCount = 0;
+	std::atomic<uint64_t> m_failureCount = 0;
+	int32_t m_consecutiveFailure = 0;
+
+	bool m_isRun = false;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::thread m_thread;
+};
+
+// 재시도 정책 인터페이스
+// 실패한 쿼리의 에러 분류와 시도 횟수로 재시도 여부와 대기 시간을 결정한다.
+class IRetryPolicy
+{
+public:
+	using _error_class_t = OdbcError::eErrorClass;
+
+	virtual ~IRetryPolicy() = default;
+
+	// attempt는 1부터 시작하며 재시도할 경우 true와 함께 대기 시간을 반환한다.
+	virtual bool ShouldRetry(_error_class_t errorClass, int32_t attempt, std::chrono::milliseconds& out_delay) = 0;
+};
+
+// 에러 분류별 최대 시도 횟수와 지수 백오프(exponential backoff) + jitter로 재시도하는 기본 정책
+class RetryPolicy : public IRetryPolicy
+{
+public:
+	struct Rule
+	{
+		int32_t maxAttempts = 1;	// 첫 실행 포함 (1일 경우 재시도 안함)
+		std::chrono::milliseconds baseDelay = std::chrono::milliseconds(0);
+		std::chrono::milliseconds maxDelay = std::chrono::milliseconds(0);
+	};
+
+	// 타임아웃은 서버에서 실행이 끝났을 수 있으므로 기본으로 재시도하지 않는다.
+	RetryPolicy()
+	{
+		SetRule(_error_class_t::Deadlock, Rule{ 3, std::chrono::milliseconds(10), std::chrono::milliseconds(200) });
+		SetRule(_error_class_t::Connection, Rule{ 2, std::chrono::milliseconds(50), std::chrono::milliseconds(1000) });
+	}
+
+	void SetRule(_error_class_t errorClass, const Rule& rule)
+	{
+		m_rules[static_cast<size_t>(errorClass)] = rule;
+	}
+
+	virtual bool ShouldRetry(_error_class_t errorClass, int32_t attempt, std::chrono::milliseconds& out_delay) override
+	{
+		const auto& rule = m_rules[static_cast<size_t>(errorClass)];
+		if (rule.maxAttempts <= attempt)
+		{
+			return false;
+		}
+
+		// base * 2^(attempt - 1)을 최대 값으로 제한한 후 절반은 고정, 절반은 무작위로 대기한다. (equal jitter)
+		auto delay = rule.baseDelay * (static_cast<int64_t>(1) << (std::min)(attempt - 1, 16));
+		delay = (std::min)(delay, rule.maxDelay);
+
+		auto half = delay.count() / 2;
+		std::uniform_int_distribution<int64_t> distribution(0, half);
+		out_delay = std::chrono::milliseconds(delay.count() - half + distribution(GetRandomEngine()));
+
+		return true;
+	}
+
+private:
+	static std::mt19937_64& GetRandomEngine()
+	{
+		static thread_local std::mt19937_64 engine(std::random_device{}());
+		return engine;
+	}
+
+	std::array<Rule, static_cast<size_t>(_error_class_t::Max)> m_rules = {};
+};
+
+// 재시도 예산
+// 요청마다 일정 비율의 토큰을 적립하고 재시도마다 1개를 사용하여 재시도가 전체 요청의 일정 비율을 넘지 않도록 한다.
+// (DB 장애 시 재시도로 인해 부하가 증폭되는 것을 막는다.)
+class RetryBudget
+{
+public:
+	// percent : 요청 대비 허용할 재시도 비율, capacity : 적립 가능한 최대 토큰 수 (처음에는 가득 찬 상태)
+	void Setup(int32_t percent, int32_t capacity)
+	{
+		m_deposit = (std::max)(0, percent) * TOKEN_UNIT / 100;
+		m_capacity = static_cast<int64_t>((std::max)(0, capacity)) * TOKEN_UNIT;
+		m_tokens.store(m_capacity, std::memory_order_relaxed);
+	}
+
+	void Deposit()
+	{
+		int64_t tokens = m_tokens.load(std::memory_order_relaxed);
+		while (tokens < m_capacity)
+		{
+			if (true == m_tokens.compare_exchange_weak(tokens, (std::min)(tokens + m_deposit, m_capacity), std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+	}
+
+	bool TryWithdraw()
+	{
+		int64_t tokens = m_tokens.load(std::memory_order_relaxed);
+		while (TOKEN_UNIT <= tokens)
+		{
+			if (true == m_tokens.compare_exchange_weak(tokens, tokens - TOKEN_UNIT, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	// 토큰 1개 (소수 단위 적립을 위해 1000배로 관리한다.)
+	static constexpr int64_t TOKEN_UNIT = 1000;
+
+	int64_t m_deposit = 0;
+	int64_t m_capacity = 0;
+	std::atomic<int64_t> m_tokens = 0;
+};
+
+// DB 연결 객체를 관리합니다.(ODBC Pool)
+// 사용은 선택적으로..
+// 1. TLS로 쓰레드별 관리 (OdbcPool<NonThreadSafeQueue>, OdbcPoolTls)
+// 2. 멀티 쓰레드 환경에서 사용 가능하도록 처리 (OdbcPool<ThreadSafeQueue>, 최대 연결 수는 전체 쓰레드에 적용된다.)
+template <typename Queue>
+class OdbcPool
+{
+	static_assert(std::is_base_of_v<IQueue<std::shared_ptr<Odbc>>, Queue>, "A Queue had not inherit a IQueue class.");
+
+public:
+	OdbcPool() 
+		: m_pool(new Queue)
+	{
+	}
+
+	~OdbcPool()
+	{
+		StopReplenisher();
+	}
+
+	inline bool HasLogging() 
+	{
+		return (nullptr != m_logging);
+	}
+
+	inline auto& GetMonitor()
+	{
+		return m_monitor;
+	}
+
+	// 현재 유지하려는 대기 연결 수 (minIdleCount ~ maxIdleCount)
+	inline int32_t GetIdleTarget()
+	{
+		return m_idleTarget.load(std::memory_order_relaxed);
+	}
+
+	void AttachLogging(_logging_ptr_t& logging)
+	{
+		m_logging = logging;
+
+		if (nullptr != m_healthChecker && false == m_healthChecker->HasLogging())
+		{
+			m_healthChecker->AttachLogging(logging);
+		}
+	}
+
+	void DetachLogging()
+	{
+		m_logging = nullptr;
+	}
+
+	// 여러 풀이 같은 endpoint의 상태 확인을 공유할 때 Initialize 전에 설정한다.
+	void AttachHealthChecker(std::shared_ptr<EndpointHealthChecker> healthChecker)
+	{
+		m_healthChecker = std::move(healthChecker);
+	}
+
+	inline auto& GetHealthChecker()
+	{
+		return m_healthChecker;
+	}
+
+	// 여러 풀이 같은 endpoint의 circuit breaker를 공유할 때 Initialize 전에 설정한다.
+	void AttachCircuitBreaker(std::shared_ptr<CircuitBreaker> circuitBreaker)
+	{
+		m_circuitBreaker = std::move(circuitBreaker);
+	}
+
+	inline auto& GetCircuitBreaker()
+	{
+		return m_circuitBreaker;
+	}
+
+	// Execute에서 사용할 재시도 정책 (설정하지 않으면 Initialize에서 RetryPolicy를 사용한다.)
+	void AttachRetryPolicy(std::shared_ptr<IRetryPolicy> retryPolicy)
+	{
+		m_retryPolicy = std::move(retryPolicy);
+	}
+
+	bool Initialize(const OdbcConfiguration& configuration)
+	{
+		m_configuration = configuration;
+
+		m_isRun = true;
+
+		if (true == m_configuration.useDriverConnectionPooling)
+		{
+			OdbcEnvironment::EnableConnectionPooling(true);
+		}
+
+		if (nullptr == m_retryPolicy)
+		{
+			m_retryPolicy = std::make_shared<RetryPolicy>();
+		}
+
+		m_retryBudget.Setup(m_configuration.retryBudgetPercent, m_configuration.retryBudgetCapacity);
+
+		if (0 < m_configuration.circuitBreakerFailureCount && nullptr == m_circuitBreaker)
+		{
+			m_circuitBreaker = std::make_shared<CircuitBreaker>(m_configuration);
+		}
+
+		if (0 < m_configuration.healthCheckIntervalMs && nullptr == m_healthChecker)
+		{
+			m_healthChecker = std::make_shared<EndpointHealthChecker>();
+			if (nullptr != m_logging)
+			{
+				m_healthChecker->AttachLogging(m_logging);
+			}
+
+			m_healthChecker->Start(m_configuration);
+		}
+
+		m_idleTarget = (std::max)(0, m_configuration.minIdleCount);
+		m_reapDeadline = (std::chrono::steady_clock::now() + std::chrono::milliseconds(m_configuration.idleTimeoutMs)).time_since_epoch().count();
+
+		if (0 < m_configuration.minIdleCount)
+		{
+			// 첫 요청이 연결을 기다리지 않도록 미리 연결한다.
+			for (auto& odbc : ConnectParallel(m_configuration.minIdleCount))
+			{
+				m_pool->Put(std::move(odbc));
+			}
+		}
+
+		if (0 < m_configuration.minIdleCount || 0 < m_configuration.maxIdleCount || (0 < m_configuration.idleTimeoutMs && true == IsThreadSafeQueue<Queue>::value))
+		{
+			StartReplenisher();
+		}
+
+		return true;
+	}
+
+	void Finalize()
+	{
+		m_isRun = false;
+
+		StopReplenisher();
+
+		CleanUp();
+	}
+
+	// 모든 연결을 종료합니다.
+	// minIdleCount를 사용하는 경우 대기 연결은 백그라운드에서 다시 채워진다.
+	void CleanUp()
+	{
+		// 현재 사용하지 않고 있는 것들...종료 처리
+		while (true)
+		{
+			std::shared_ptr<Odbc> odbc;
+			if (false == m_pool->TryPop(odbc) && false == TryPopReplenished(odbc))
+			{
+				break;
+			}
+
+			odbc->CleanUp();
+			odbc.reset();
+
+			m_monitor.Cleanup();
+		}
+
+		NotifyReplenisher();
+	}
+
+	// CleanUp 호출되면 nullptr을 반환한다.
+	// endpoint가 Down 상태이면 연결 시간 초과를 기다리지 않고 nullptr을 반환한다.
+	std::shared_ptr<Odbc> GetConnection()
+	{
+		if (false == m_isRun)
+		{
+			return nullptr;
+		}
+
+		if (nullptr != m_healthChecker && true == m_healthChecker->IsDown())
+		{
+			return nullptr;
+		}
+
+		// 차단 중이면 연결을 시도하지 않고 바로 실패한다.
+		if (false == AcquireCircuit())
+		{
+			return nullptr;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+
+		// 다른 연결에서 연결 문제가 발생한 이후 처음 사용하는 대기 연결은 상태를 확인한다.
+		// 최대 수명이 지난 대기 연결은 사용하지 않고 종료한다.
+		std::shared_ptr<Odbc> odbc;
+		while (true == m_pool->TryPop(odbc) || true == TryPopReplenished(odbc))
+		{
+			bool isExpired = IsExpired(odbc, now);
+			if (false == isExpired && true == Validate(odbc))
+			{
+				break;
+			}
+
+			odbc->CleanUp();
+			odbc.reset();
+
+			m_monitor.Cleanup();
+			if (true == isExpired)
+			{
+				m_monitor.AddLifetimeEviction();
+			}
+			else
+			{
+				m_monitor.AddStaleEviction();
+			}
+		}
+
+		if (nullptr == odbc)
+		{
+			// 여러 쓰레드가 동시에 생성하더라도 최대 연결 수를 넘지 않도록 먼저 예약한다.
+			if (false == m_monitor.TryCreate(m_configuration.maxOdbcCount))
+			{
+				OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, "A new connection can not create because over max connection.");
+				return nullptr;
+			}
+
+			odbc = Connect();
+			if (nullptr == odbc)
+			{
+				return nullptr;
+			}
+
+			// 대기 연결이 없어 연결을 기다린 시간 (대기 연결 목표 수 조정에 사용)
+			m_monitor.AddWait(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count());
+		}
+
+		// 사용 중으로 변경
+		odbc->SetState(Odbc::eState::Used);
+
+		m_monitor.Allocate();
+
+		auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count();
+		m_monitor.RecordCheckout(wait);
+		odbc->SetCheckoutWait(wait);
+
+		if (m_monitor.GetFree() < m_idleTarget.load(std::memory_order_relaxed))
+		{
+			NotifyReplenisher();
+		}
+
+		ReapIdle(now);
+
+		return odbc;
+	}
+
+	// 문제가 발생한 연결을 풀에 반환하지 않고 종료한다.
+	void Discard(std::shared_ptr<Odbc>&& odbc)
+	{
+		if (false == odbc->SetFreeState())
+		{
+			return;
+		}
+
+		m_monitor.AddStatementCacheStats(odbc->TakeStatementCacheStats());
+
+		odbc->CleanUp();
+		odbc.reset();
+
+		m_monitor.ReleaseAndCleanup();
+		m_monitor.AddEviction();
+	}
+
+	// 실행 결과에 따라 연결을 반환하거나 종료한다.
+	// 연결 문제(OdbcError::IsCritical)가 발생한 연결만 종료하며 쿼리 에러 등은 연결을 그대로 반환한다.
+	// 나머지 대기 연결은 풀 세대를 증가시켜 다음 사용 시 확인한다. (CleanUp으로 모두 종료하지 않는다.)
+	void Release(std::shared_ptr<Odbc>&& odbc, SQLRETURN resultCode)
+	{
+		if (SQL_SUCCESS == resultCode || SQL_SUCCESS_WITH_INFO == resultCode || SQL_NO_DATA == resultCode)
+		{
+			Release(std::move(odbc));
+			ReportCircuit(true);
+			return;
+		}
+
+		// 에러 정보가 없으면 드라이버가 알고 있는 연결 상태로 판단한다.
+		auto error = odbc->GetLastError();
+		bool isCritical = (nullptr != error) ? error->IsCritical() : odbc->IsConnectionDead();
+		if (false == isCritical)
+		{
+			// 쿼리 에러는 연결에 문제가 없으므로 성공으로 본다.
+			Release(std::move(odbc));
+			ReportCircuit(true);
+			return;
+		}
+
+		m_generation.fetch_add(1, std::memory_order_relaxed);
+
+		Discard(std::move(odbc));
+		ReportCircuit(false);
+	}
+
+	// 연결을 받아 쿼리를 실행한 후 반환한다.
+	// 실패한 경우 에러 분류에 따라 재시도 정책과 풀의 재시도 예산 안에서 다시 실행한다.
+	// 연결을 받지 못한 경우는 실행 전이므로 재시도하며, 실행한 후의 실패는 IQuery::IsIdempotent인 쿼리만 재시도한다.
+	// (연결이 끊어졌더라도 서버에서는 이미 실행되었을 수 있다.)
+	SQLRETURN Execute(IQuery* query, _odbc_error_ptr_t& out_error)
+	{
+		m_retryBudget.Deposit();
+
+		for (int32_t attempt = 1; ; ++attempt)
+		{
+			SQLRETURN resultCode = SQL_ERROR;
+			bool isExecuted = false;
+			out_error = nullptr;
+
+			auto connection = GetConnection();
+			if (nullptr != connection)
+			{
+				isExecuted = true;
+				resultCode = connection->Execute(query);
+				out_error = connection->GetLastError();
+
+				Release(std::move(connection), resultCode);
+			}
+			else if (false == m_isRun || true == IsBlocked())
+			{
+				// 종료 중이거나 차단된 상태에서는 재시도 대기 없이 바로 실패한다.
+				return resultCode;
+			}
+
+			if (SQL_SUCCESS == resultCode || SQL_SUCCESS_WITH_INFO == resultCode || SQL_NO_DATA == resultCode)
+			{
+				return resultCode;
+			}
+
+			if (true == isExecuted && false == query->IsIdempotent())
+			{
+				return resultCode;
+			}
+
+			// 연결을 받지 못한 경우 연결 문제로 분류한다.
+			auto errorClass = (nullptr != out_error) ? out_error->GetErrorClass() : OdbcError::eErrorClass::Connection;
+
+			std::chrono::milliseconds delay(0);
+			if (nullptr == m_retryPolicy || false == m_retryPolicy->ShouldRetry(errorClass, attempt, delay))
+			{
+				return resultCode;
+			}
+
+			if (false == m_retryBudget.TryWithdraw())
+			{
+				m_monitor.AddRetryBudgetExhausted();
+				return resultCode;
+			}
+
+			m_monitor.AddRetry(errorClass);
+
+			// 이전 시도에서 읽은 결과를 정리한다. (실행 전 실패는 DAO에 전달된 결과가 없다.)
+			if (true == isExecuted)
+			{
+				query->GetDao()->Reset();
+			}
+
+			std::this_thread::sleep_for(delay);
+		}
+	}
+
+	void Release(std::shared_ptr<Odbc>&& odbc)
+	{
+		// Used -> Free로 만 상태 변경이 가능. 
+		// Atomic compare_exchange_strong 처리 
+		if (false == odbc->SetFreeState())
+		{
+			return;
+		}
+
+		m_monitor.AddStatementCacheStats(odbc->TakeStatementCacheStats());
+
+		if (false == m_isRun)
+		{
+			// 해제한다.
+			odbc->CleanUp();
+			odbc.reset();
+
+			m_monitor.ReleaseAndCleanup();
+			return;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (true == IsExpired(odbc, now))
+		{
+			// 최대 수명이 지난 연결은 반환하지 않고 종료한다.
+			odbc->CleanUp();
+			odbc.reset();
+
+			m_monitor.ReleaseAndCleanup();
+			m_monitor.AddLifetimeEviction();
+
+			NotifyReplenisher();
+			return;
+		}
+
+		m_pool->Put(std::forward<std::shared_ptr<Odbc>>(odbc));
+
+		m_monitor.Release();
+
+		ReapIdle(now);
+	}
+
+private:
+	// 동시에 연결을 시도하는 최대 쓰레드 수
+	static constexpr int32_t MAX_CONNECT_THREAD_COUNT = 8;
+
+	template <ILogging::eLevel level, typename... Args>
+	void OnLog(const char* function, int32_t line, std::string_view format, Args... args)
+	{
+		if (nullptr == m_logging)
+		{
+			return;
+		}
+
+		// TODO:: ostream을 상속받아 내부적으로 fmt를 쓰게하자!
+		std::stringstream ss;
+		ss << "[" << NamedLoggingLevel<level>::Name() << "][" << function << "(" << line << ")][" << format << "]";
+
+		std::string message = ss.str();
+
+		switch (level)
+		{
+		case ILogging::eLevel::Trace:
+			m_logging->Trace(message);
+			break;
+		case ILogging::eLevel::Debug:
+			m_logging->Debug(message);
+			break;
+		case ILogging::eLevel::Info:
+			m_logging->Info(message);
+			break;
+		case ILogging::eLevel::Warning:
+			m_logging->Warning(message);
+			break;
+		case ILogging::eLevel::Error:
+			m_logging->Error(message);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// 풀 세대가 바뀐 이후 처음 사용하는 연결이면 상태를 확인한다.
+	bool Validate(std::shared_ptr<Odbc>& odbc)
+	{
+		uint64_t generation = m_generation.load(std::memory_order_relaxed);
+		if (generation == odbc->GetGeneration())
+		{
+			return true;
+		}
+
+		if (true == odbc->IsConnectionDead())
+		{
+			return false;
+		}
+
+		odbc->SetGeneration(generation);
+
+		return true;
+	}
+
+	inline bool IsExpired(std::shared_ptr<Odbc>& odbc, std::chrono::steady_clock::time_point now)
+	{
+		return (0 < m_configuration.maxLifetimeMs && std::chrono::milliseconds(m_configuration.maxLifetimeMs) <= now - odbc->GetConnectedTime());
+	}
+
+	// idleTimeoutMs 마다 그 동안 사용되지 않은 대기 연결을 종료한다.
+	// 풀은 스택이므로 구간 동안의 최소 대기 연결 수(Monitor::TakeLowFree)만큼은 한 번도 꺼내지 않은 연결이며 목표 수를 넘는 만큼 종료한다.
+	// Queue가 쓰레드에 안전하지 않으면 풀을 사용하는 쓰레드(GetConnection, Release)에서만 호출해야 한다.
+	void ReapIdle(std::chrono::steady_clock::time_point now)
+	{
+		if (0 >= m_configuration.idleTimeoutMs)
+		{
+			return;
+		}
+
+		auto deadline = m_reapDeadline.load(std::memory_order_relaxed);
+		if (now.time_since_epoch().count() < deadline)
+		{
+			return;
+		}
+
+		auto next = (now + std::chrono::milliseconds(m_configuration.idleTimeoutMs)).time_since_epoch().count();
+		if (false == m_reapDeadline.compare_exchange_strong(deadline, next, std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		int32_t surplus = m_monitor.TakeLowFree() - m_idleTarget.load(std::memory_order_relaxed);
+		for (; 0 < surplus; --surplus)
+		{
+			std::shared_ptr<Odbc> odbc;
+			if (false == m_pool->TryPop(odbc) && false == TryPopReplenished(odbc))
+			{
+				break;
+			}
+
+			odbc->CleanUp();
+			odbc.reset();
+
+			m_monitor.Cleanup();
+			m_monitor.AddIdleEviction();
+		}
+	}
+
+	// 대기 연결이 없어 연결을 기다린 요청이 있고 평균 대기 시간이 growthWaitMs 이상이면 그 수만큼 목표 수를 늘린다. (maxIdleCount까지)
+	// 기다린 요청이 없으면 minIdleCount까지 하나씩 줄인다.
+	void AdjustIdleTarget()
+	{
+		if (0 >= m_configuration.maxIdleCount)
+		{
+			return;
+		}
+
+		uint64_t wait = m_monitor.GetWait();
+		uint64_t waitTime = m_monitor.GetWaitTime();
+
+		uint64_t count = wait - m_lastWait;
+		uint64_t time = waitTime - m_lastWaitTime;
+
+		m_lastWait = wait;
+		m_lastWaitTime = waitTime;
+
+		int32_t minCount = (std::max)(0, m_configuration.minIdleCount);
+		int32_t maxCount = (std::max)(minCount, m_configuration.maxIdleCount);
+		int32_t target = m_idleTarget.load(std::memory_order_relaxed);
+
+		if (0 == count)
+		{
+			target = (std::max)(minCount, target - 1);
+		}
+		else if (static_cast<uint64_t>((std::max)(0, m_configuration.growthWaitMs)) * 1000 <= time / count)
+		{
+			target = static_cast<int32_t>((std::min)(static_cast<uint64_t>(maxCount), static_cast<uint64_t>(target) + count));
+		}
+
+		m_idleTarget.store(target, std::memory_order_relaxed);
+	}
+
+	// 새 연결을 생성한다. 생성 수는 호출 전에 TryCreate로 예약되어 있어야 한다.
+	std::shared_ptr<Odbc> Connect()
+	{
+		std::shared_ptr<Odbc> odbc(new Odbc);
+		odbc->SetGeneration(m_generation.load(std::memory_order_relaxed));
+		int32_t maxStatementCount = (std::max)(1, m_configuration.maxStatementCount);
+		odbc->SetStatementCacheCapacity((std::clamp)(m_configuration.statementCacheCapacity, 0, maxStatementCount));
+		odbc->SetMaxStatementCount(maxStatementCount);
+		odbc->SetArenaSize(static_cast<size_t>((std::max)(0, m_configuration.arenaSize)));
+
+		if (true == m_configuration.useQueryMetrics)
+		{
+			odbc->SetQueryMetrics(m_monitor.GetQueryMetrics());
+		}
+
+		if (false == odbc->Setup(m_configuration.connectionString.c_str(), m_logging))
+		{
+			m_monitor.Cleanup();
+			ReportCircuit(false);
+			return nullptr;
+		}
+
+		ReportCircuit(true);
+
+		return odbc;
+	}
+
+	// endpoint가 Down이거나 차단기가 닫혀 있지 않아 연결을 시도하지 않는 상태
+	bool IsBlocked()
+	{
+		if (nullptr != m_healthChecker && true == m_healthChecker->IsDown())
+		{
+			return true;
+		}
+
+		return (nullptr != m_circuitBreaker && CircuitBreaker::eState::Closed != m_circuitBreaker->GetState());
+	}
+
+	bool AcquireCircuit()
+	{
+		if (nullptr == m_circuitBreaker)
+		{
+			return true;
+		}
+
+		bool changed = false;
+		bool acquired = m_circuitBreaker->TryAcquire(changed);
+		if (true == changed)
+		{
+			OnCircuitChanged();
+		}
+
+		return acquired;
+	}
+
+	void ReportCircuit(bool success)
+	{
+		if (nullptr == m_circuitBreaker)
+		{
+			return;
+		}
+
+		bool changed = (true == success) ? m_circuitBreaker->OnSuccess() : m_circuitBreaker->OnFailure();
+		if (true == changed)
+		{
+			OnCircuitChanged();
+		}
+	}
+
+	void OnCircuitChanged()
+	{
+		auto state = m_circuitBreaker->GetState();
+
+		std::string message = "The circuit breaker state is changed to ";
+		message += CircuitBreaker::NamedState(state);
+
+		if (CircuitBreaker::eState::Closed == state)
+		{
+			OnLog<ILogging::eLevel::Info>(__FUNCTION__, __LINE__, message);
+		}
+		else
+		{
+			OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, message);
+		}
+	}
+
+	// 최대 연결 수 안에서 count 개의 연결을 여러 쓰레드로 나누어 동시에 생성한다.
+	std::vector<std::shared_ptr<Odbc>> ConnectParallel(int32_t count)
+	{
+		std::vector<std::shared_ptr<Odbc>> connections(static_cast<size_t>(count));
+		std::atomic<int32_t> next = 0;
+
+		auto work = [this, &connections, &next, count]()
+		{
+			for (int32_t i = next++; i < count; i = next++)
+			{
+				if (false == m_monitor.TryCreate(m_configuration.maxOdbcCount))
+				{
+					break;
+				}
+
+				connections[i] = Connect();
+			}
+		};
+
+		std::vector<std::thread> threadGroup;
+		for (int32_t i = 1; i < (std::min)(count, MAX_CONNECT_THREAD_COUNT); ++i)
+		{
+			threadGroup.emplace_back(work);
+		}
+
+		work();
+
+		for (auto& t : threadGroup)
+		{
+			t.join();
+		}
+
+		connections.erase(std::remove(connections.begin(), connections.end(), nullptr), connections.end());
+
+		return connections;
+	}
+
+	// 백그라운드에서 채운 연결은 Queue가 쓰레드에 안전하지 않을 수 있으므로 별도의 큐로 전달한다.
+	bool TryPopReplenished(std::shared_ptr<Odbc>& odbc)
+	{
+		return (nullptr != m_replenished && true == m_replenished->TryPop(odbc));
+	}
+
+	void StartReplenisher()
+	{
+		int32_t capacity = (std::max)({ 1, m_configuration.minIdleCount, m_configuration.maxIdleCount });
+		m_replenished.reset(new MpmcQueue<std::shared_ptr<Odbc>>(static_cast<size_t>(capacity)));
+
+		m_isReplenishRun = true;
+		m_replenishThread = std::thread([this]() { Replenish(); });
+	}
+
+	void StopReplenisher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_replenishMutex);
+			m_isReplenishRun = false;
+		}
+
+		m_replenishCondition.notify_all();
+
+		if (true == m_replenishThread.joinable())
+		{
+			m_replenishThread.join();
+		}
+	}
+
+	inline void NotifyReplenisher()
+	{
+		if (nullptr != m_replenished)
+		{
+			m_replenishCondition.notify_one();
+		}
+	}
+
+	// 대기 연결이 목표 수(GetIdleTarget)보다 적으면 부족한 만큼 연결하여 채운다.
+	// 쓰레드에 안전한 Queue는 풀을 사용하는 쓰레드가 없어도 사용되지 않는 연결을 여기서 정리한다.
+	void Replenish()
+	{
+		auto interval = std::chrono::milliseconds((std::max)(1, m_configuration.replenishIntervalMs));
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_replenishMutex);
+				m_replenishCondition.wait_for(lock, interval);
+
+				if (false == m_isReplenishRun)
+				{
+					break;
+				}
+			}
+
+			AdjustIdleTarget();
+
+			if constexpr (true == IsThreadSafeQueue<Queue>::value)
+			{
+				ReapIdle(std::chrono::steady_clock::now());
+			}
+
+			int32_t lack = m_idleTarget.load(std::memory_order_relaxed) - m_monitor.GetFree();
+			if (0 >= lack)
+			{
+				continue;
+			}
+
+			// 연결할 수 없는 상태에서는 시도하지 않는다.
+			if (true == IsBlocked())
+			{
+				continue;
+			}
+
+			for (auto& odbc : ConnectParallel(lack))
+			{
+				if (false == m_replenished->TryPut(odbc))
+				{
+					odbc->CleanUp();
+					m_monitor.Cleanup();
+				}
+			}
+		}
+	}
+
+	// 쓰레드 마다 Manager를 가진다면..?? 
+	// 누가 취합하지???
+	// 이 경우 전체 연결 수와 사용 현황을 모니터링 할 수 있는 기능이 필요하다.
+	// 결국 모니터링 메트릭에 변화가 생길 경우 이를 노티 받아야한다.
+
+
+	// ODBC 객체 사용 현황을 체크하기 위한 모니터 객체
+	class Monitor
+	{
+	public:
+		inline int32_t GetTotal() { return m_total; }
+		inline int32_t GetUsed() { return m_used; }
+		inline int32_t GetFree() { return m_free; }
+
+		void Create() { ++m_total; ++m_free; }
+
+		// 최대 연결 수(0 이하일 경우 제한 없음)를 넘지 않을 경우에만 생성 수를 증가시킨다.
+		bool TryCreate(int32_t maxCount)
+		{
+			int32_t total = m_total.load();
+			do
+			{
+				if (0 < maxCount && maxCount <= total)
+				{
+					return false;
+				}
+			} while (false == m_total.compare_exchange_weak(total, total + 1));
+
+			++m_free;
+
+			return true;
+		}
+		void Allocate()
+		{
+			int32_t free = --m_free;
+			++m_used;
+
+			int32_t low = m_lowFree.load(std::memory_order_relaxed);
+			while (free < low && false == m_lowFree.compare_exchange_weak(low, free, std::memory_order_relaxed))
+			{
+			}
+		}
+		void Release() { ++m_free; --m_used; }
+		void Cleanup() { --m_total; --m_free; }
+		void ReleaseAndCleanup() { Release(); Cleanup(); }
+
+		// 연결 문제로 종료한 연결 수
+		inline uint64_t GetEviction() { return m_eviction; }
+
+		// 지연 검증에서 끊어진 것이 확인되어 종료한 대기 연결 수
+		inline uint64_t GetStaleEviction() { return m_staleEviction; }
+
+		void AddEviction() { ++m_eviction; }
+		void AddStaleEviction() { ++m_staleEviction; }
+
+		// idleTimeoutMs 동안 사용되지 않아 종료한 대기 연결 수
+		inline uint64_t GetIdleEviction() { return m_idleEviction; }
+
+		// maxLifetimeMs가 지나 종료한 연결 수
+		inline uint64_t GetLifetimeEviction() { return m_lifetimeEviction; }
+
+		void AddIdleEviction() { ++m_idleEviction; }
+		void AddLifetimeEviction() { ++m_lifetimeEviction; }
+
+		// 대기 연결이 없어 새로 연결하기를 기다린 요청 수와 대기 시간 합계 (us)
+		inline uint64_t GetWait() { return m_wait; }
+		inline uint64_t GetWaitTime() { return m_waitTime; }
+
+		void AddWait(int64_t us)
+		{
+			++m_wait;
+			m_waitTime += static_cast<uint64_t>((std::max)(int64_t(0), us));
+		}
+
+		// 마지막 호출 이후 대기 연결 수의 최소값을 반환하고 현재 값으로 초기화한다.
+		int32_t TakeLowFree()
+		{
+			int32_t free = m_free;
+			int32_t low = m_lowFree.exchange(free);
+			return (std::min)(low, free);
+		}
+
+		// 에러 분류별 재시도 수
+		inline uint64_t GetRetry(OdbcError::eErrorClass errorClass) { return m_retry[static_cast<size_t>(errorClass)]; }
+
+		// 재시도 예산이 부족하여 재시도하지 않은 수
+		inline uint64_t GetRetryBudgetExhausted() { return m_retryBudgetExhausted; }
+
+		void AddRetry(OdbcError::eErrorClass errorClass) { ++m_retry[static_cast<size_t>(errorClass)]; }
+		void AddRetryBudgetExhausted() { ++m_retryBudgetExhausted; }
+
+		inline uint64_t GetStatementCacheHit() { return m_statementCacheHit; }
+		inline uint64_t GetStatementCacheMiss() { return m_statementCacheMiss; }
+		inline uint64_t GetStatementCacheEviction() { return m_statementCacheEviction; }
+
+		void AddStatementCacheStats(const Odbc::StatementCacheStats& stats)
+		{
+			m_statementCacheHit += stats.hit;
+			m_statementCacheMiss += stats.miss;
+			m_statementCacheEviction += stats.eviction;
+		}
+
+		// 쿼리 스크립트별 실행 기록 (연결들이 공유한다.)
+		inline const std::shared_ptr<QueryMetrics>& GetQueryMetrics() { return m_queryMetrics; }
+
+		// GetConnection이 연결을 반환하기까지 걸린 시간 (us)
+		void RecordCheckout(int64_t us) { m_checkout.Record(us); }
+
+		struct Snapshot
+		{
+			int32_t total = 0;
+			int32_t used = 0;
+			int32_t free = 0;
+
+			uint64_t eviction = 0;
+			uint64_t staleEviction = 0;
+			uint64_t idleEviction = 0;
+			uint64_t lifetimeEviction = 0;
+
+			LatencyHistogram::Snapshot checkout;
+			std::vector<QueryMetrics::Snapshot> queries;
+		};
+
+		// 카운터와 히스토그램을 relaxed로 읽어 복사하므로 기록을 멈추지 않는다.
+		Snapshot GetSnapshot()
+		{
+			Snapshot snapshot;
+			snapshot.total = m_total;
+			snapshot.used = m_used;
+			snapshot.free = m_free;
+			snapshot.eviction = m_eviction;
+			snapshot.staleEviction = m_staleEviction;
+			snapshot.idleEviction = m_idleEviction;
+			snapshot.lifetimeEviction = m_lifetimeEviction;
+
+			m_checkout.GetSnapshot(snapshot.checkout);
+			snapshot.queries = m_queryMetrics->GetSnapshot();
+
+			return snapshot;
+		}
+
+		// 현황을 반환한다. 
+		// 형식) 0 total, 0 free, 0 used, checkout(count 0, p50 0us, p99 0us, max 0us)
+		//       [script] count 0, error 0, rows 0, bytes 0, checkout(...), prepare(...), execute(...), fetch(...), total(...)
+		std::string ToString() 
+		{
+			auto snapshot = GetSnapshot();
+
+			std::stringstream ss;
+			ss << snapshot.total << " total, " << snapshot.free << " free, " << snapshot.used << " used, checkout" << ToString(snapshot.checkout);
+
+			for (const auto& query : snapshot.queries)
+			{
+				const auto& total = query.Get(QueryMetrics::ePhase::Total);
+
+				ss << "\n[" << (true == query.script.empty() ? "others" : query.script) << "] count " << total.count
+					<< ", error " << query.error << ", rows " << query.rows << ", bytes " << query.bytes;
+
+				for (size_t i = 0; i < query.phases.size(); ++i)
+				{
+					ss << ", " << QueryMetrics::NamedPhase(static_cast<QueryMetrics::ePhase>(i)) << ToString(query.phases[i]);
+				}
+			}
+
+			return ss.str();
+		}
+
+	private:
+		std::atomic_int32_t m_total = 0;
+		std::atomic_int32_t m_used = 0;
+		std::atomic_int32_t m_free = 0;
+
+		std::atomic_int32_t m_lowFree = (std::numeric_limits<int32_t>::max)();
+
+		std::atomic_uint64_t m_eviction = 0;
+		std::atomic_uint64_t m_staleEviction = 0;
+		std::atomic_uint64_t m_idleEviction = 0;
+		std::atomic_uint64_t m_lifetimeEviction = 0;
+
+		std::atomic_uint64_t m_wait = 0;
+		std::atomic_uint64_t m_waitTime = 0;
+
+		std::array<std::atomic_uint64_t, static_cast<size_t>(OdbcError::eErrorClass::Max)> m_retry = {};
+		std::atomic_uint64_t m_retryBudgetExhausted = 0;
+
+		std::atomic_uint64_t m_statementCacheHit = 0;
+		std::atomic_uint64_t m_statementCacheMiss = 0;
+		std::atomic_uint64_t m_statementCacheEviction = 0;
+
+		LatencyHistogram m_checkout;
+		std::shared_ptr<QueryMetrics> m_queryMetrics = std::make_shared<QueryMetrics>();
+
+		static std::string ToString(const LatencyHistogram::Snapshot& histogram)
+		{
+			std::stringstream ss;
+			ss << "(count " << histogram.count << ", p50 " << histogram.GetPercentile(0.5) << "us, p99 " << histogram.GetPercentile(0.99) << "us, max " << histogram.max << "us)";
+
+			return ss.str();
+		}
+	};
+	
+	Monitor m_monitor;
+
+	std::atomic_bool m_isRun = false;
+
+	// 연결 문제가 발생할 때마다 증가하며 대기 연결은 세대가 다르면 사용 전에 확인한다.
+	std::atomic<uint64_t> m_generation = 0;
+
+	// 대기 연결 목표 수 (minIdleCount ~ maxIdleCount)
+	std::atomic_int32_t m_idleTarget = 0;
+	uint64_t m_lastWait = 0;
+	uint64_t m_lastWaitTime = 0;
+
+	// 다음에 사용되지 않는 대기 연결을 정리할 시각 (steady_clock)
+	std::atomic<std::chrono::steady_clock::rep> m_reapDeadline = 0;
+
+	// 대기 연결 보충 (minIdleCount)
+	std::unique_ptr<MpmcQueue<std::shared_ptr<Odbc>>> m_replenished;
+	std::thread m_replenishThread;
+	std::mutex m_replenishMutex;
+	std::condition_variable m_replenishCondition;
+	bool m_isReplenishRun = false;
+
+	OdbcConfiguration m_configuration;
+
+	_logging_ptr_t m_logging;
+
+	std::shared_ptr<EndpointHealthChecker> m_healthChecker;
+	std::shared_ptr<CircuitBreaker> m_circuitBreaker;
+
+	std::shared_ptr<IRetryPolicy> m_retryPolicy;
+	RetryBudget m_retryBudget;
+
+	std::shared_ptr<IQueue<std::shared_ptr<Odbc>>> m_pool;
+};
+
+// 쓰레드별 OdbcPool을 관리하기 위한 객체
+class OdbcPoolTls
+{
+public:
+	using _key_t = std::thread::id;
+	using _value_t = std::shared_ptr<OdbcPool<NonThreadSafeQueue>>;
+	using _container_t = std::map<_key_t, _value_t>;
+
+	void SetConfiguration(const OdbcConfiguration& configuration)
+	{
+		m_configuration = configuration;
+	}
+
+	_value_t Create()
+	{
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+		auto itr = m_container.find(std::this_thread::get_id());
+		if (m_container.end() != itr)
+		{
+			return itr->second;
+		}
+
+		auto obj = std::make_shared<OdbcPool<NonThreadSafeQueue>>();
+
+		// endpoint 상태 확인은 모든 쓰레드의 풀이 공유한다.
+		if (0 < m_configuration.healthCheckIntervalMs)
+		{
+			if (nullptr == m_healthChecker)
+			{
+				m_healthChecker = std::make_shared<EndpointHealthChecker>();
+				m_healthChecker->Start(m_configuration);
+			}
+
+			obj->AttachHealthChecker(m_healthChecker);
+		}
+
+		if (0 < m_configuration.circuitBreakerFailureCount)
+		{
+			if (nullptr == m_circuitBreaker)
+			{
+				m_circuitBreaker = std::make_shared<CircuitBreaker>(m_configuration);
+			}
+
+			obj->AttachCircuitBreaker(m_circuitBreaker);
+		}
+
+		obj->Initialize(m_configuration);
+
+		m_container.emplace(std::this_thread::get_id(), obj);
+
+		return obj;
+	}
+
+	_value_t Lookup()
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+		auto itr = m_container.find(std::this_thread::get_id());
+		if (m_container.end() == itr)
+		{
+			return nullptr;
+		}
+
+		return itr->second;
+	}
+
+	void Destroy()
+	{
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+		auto itr = m_container.find(std::this_thread::get_id());
+		if (m_container.end() != itr)
+		{
+			itr->second->Finalize();
+			m_container.erase(itr);
+		}
+	}
+
+	template <typename Func>
+	void Traverse(Func&& func)
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+		for (const auto& [key, value] : m_container)
+		{
+			func(key, value);
+		}
+	}
+
+	inline auto& GetHealthChecker()
+	{
+		return m_healthChecker;
+	}
+
+	inline auto& GetCircuitBreaker()
+	{
+		return m_circuitBreaker;
+	}
+
+private:
+	std::shared_mutex m_mutex;
+	OdbcConfiguration m_configuration;
+	_container_t m_container;
+	std::shared_ptr<EndpointHealthChecker> m_healthChecker;
+	std::shared_ptr<CircuitBreaker> m_circuitBreaker;
+};
+
+// 비동기 실행(SQL_ATTR_ASYNC_ENABLE)으로 적은 수의 쓰레드가 여러 연결의 쿼리를 동시에 진행한다.
+// 쓰레드별로 OdbcPool을 가지며 요청마다 연결 1개를 점유하여 실행이 완료될 때까지 폴링한다.
+// DAO의 Parse, Process는 실행이 완료된 쓰레드에서 호출된다.
+class OdbcReactor
+{
+public:
+	using _task_t = std::shared_ptr<IQuery>;
+
+	OdbcReactor(const OdbcConfiguration& configuration)
+	{
+		m_odbcPoolTls.SetConfiguration(configuration);
+	}
+
+	~OdbcReactor()
+	{
+		Stop();
+	}
+
+	void AttachLogging(_logging_ptr_t& logging)
+	{
+		m_logging = logging;
+	}
+
+	// 쓰레드별로 동시에 실행할 최대 쿼리 수 (연결 수)
+	inline void SetMaxInFlight(size_t count) { m_maxInFlight = (std::max)(count, static_cast<size_t>(1)); }
+
+	// 진행 중인 실행 중 완료된 것이 없을 경우 다음 폴링까지 대기하는 시간
+	inline void SetPollInterval(std::chrono::microseconds interval) { m_pollInterval = interval; }
+
+	// 실행 중인 쿼리 수
+	inline size_t GetInFlight() { return m_inFlight; }
+
+	bool Start(int32_t threadCount)
+	{
+		if (true == m_isRun.exchange(true))
+		{
+			return false;
+		}
+
+		for (int32_t i = 0; i < (std::max)(threadCount, 1); ++i)
+		{
+			m_threadGroup.emplace_back([this]() { Loop(); });
+		}
+
+		return true;
+	}
+
+	// 남은 요청과 실행 중인 쿼리를 모두 처리한 후 종료한다.
+	// 연결할 수 없는 상태라면 남은 요청은 completion에 SQL_ERROR를 전달하여 실패 처리한다.
+	void Stop()
+	{
+		if (false == m_isRun.exchange(false))
+		{
+			return;
+		}
+
+		m_condition.notify_all();
+
+		for (auto& t : m_threadGroup)
+		{
+			t.join();
+		}
+
+		m_threadGroup.clear();
+	}
+
+	void Put(_task_t task)
+	{
+		Put(std::move(task), nullptr);
+	}
+
+	// 실행이 끝나면 연결을 반환한 후 completion을 호출한다.
+	void Put(_task_t task, _query_completion_t completion)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queue.push_back(Pending{ std::move(task), std::move(completion) });
+		}
+
+		m_condition.notify_one();
+	}
+
+private:
+	struct Pending
+	{
+		_task_t task;
+		_query_completion_t completion;
+	};
+
+	struct InFlight
+	{
+		_task_t task;
+		_query_completion_t completion;
+		std::shared_ptr<Odbc> connection;
+		Odbc::AsyncExecution execution;
+	};
+
+	using _pool_ptr_t = OdbcPoolTls::_value_t;
+
+	void Loop()
+	{
+		auto odbcPool = m_odbcPoolTls.Create();
+		if (false == odbcPool->HasLogging() && nullptr != m_logging)
+		{
+			odbcPool->AttachLogging(m_logging);
+		}
+
+		std::vector<InFlight> executions;
+		executions.reserve(m_maxInFlight);
+
+		while (true)
+		{
+			bool isAvailable = BeginTasks(odbcPool, executions);
+			if (false == isAvailable && false == m_isRun)
+			{
+				// 종료 중에는 연결을 기다리지 않고 남은 요청을 실패 처리한다.
+				FailPending();
+			}
+
+			if (true == executions.empty())
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if (true == m_queue.empty())
+				{
+					if (false == m_isRun)
+					{
+						break;
+					}
+
+					m_condition.wait_for(lock, IDLE_WAIT);
+					continue;
+				}
+
+				if (true == isAvailable)
+				{
+					continue;
+				}
+
+				// 연결할 수 없는 상태(endpoint Down, circuit breaker Open 등)라면 바로 다시 시도하지 않는다.
+				// 요청이 추가되어도 깨어나지 않으며 종료 시에만 깨어난다.
+				m_condition.wait_for(lock, IDLE_WAIT, [this]() { return false == m_isRun; });
+				continue;
+			}
+
+			bool completed = false;
+			for (size_t i = 0; i < executions.size();)
+			{
+				auto& inFlight = executions[i];
+				if (SQL_STILL_EXECUTING == inFlight.connection->Poll(inFlight.execution))
+				{
+					++i;
+					continue;
+				}
+
+				Complete(odbcPool, inFlight);
+
+				if (i + 1 != executions.size())
+				{
+					inFlight = std::move(executions.back());
+				}
+				executions.pop_back();
+
+				completed = true;
+			}
+
+			if (false == completed)
+			{
+				std::this_thread::sleep_for(m_pollInterval);
+			}
+		}
+
+		m_odbcPoolTls.Destroy();
+	}
+
+	// 대기 중인 요청을 가능한 만큼 꺼내 실행을 시작한다.
+	// 연결을 받지 못한 경우 false를 반환한다.
+	bool BeginTasks(_pool_ptr_t& odbcPool, std::vector<InFlight>& executions)
+	{
+		while (executions.size() < m_maxInFlight)
+		{
+			Pending pending;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (true == m_queue.empty())
+				{
+					return true;
+				}
+
+				pending = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+
+			auto connection = odbcPool->GetConnection();
+			if (nullptr == connection)
+			{
+				// 연결할 수 없는 상태라면 잠시 후 다시 시도한다.
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_queue.push_front(std::move(pending));
+				return false;
+			}
+
+			auto& inFlight = executions.emplace_back();
+			inFlight.execution = connection->BeginExecute(pending.task.get());
+			inFlight.connection = std::move(connection);
+			inFlight.task = std::move(pending.task);
+			inFlight.completion = std::move(pending.completion);
+
+			++m_inFlight;
+		}
+
+		return true;
+	}
+
+	// 대기 중인 요청을 실행하지 않고 completion에 SQL_ERROR를 전달한다.
+	void FailPending()
+	{
+		std::deque<Pending> pendings;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			pendings.swap(m_queue);
+		}
+
+		for (auto& pending : pendings)
+		{
+			if (nullptr != pending.completion)
+			{
+				_odbc_error_ptr_t error;
+				pending.completion(SQL_ERROR, error);
+			}
+		}
+	}
+
+	void Complete(_pool_ptr_t& odbcPool, InFlight& inFlight)
+	{
+		--m_inFlight;
+
+		auto resultCode = inFlight.execution.GetResult();
+		auto error = inFlight.execution.GetError();
+
+		// 연결 문제가 발생한 경우에만 풀에 반환하지 않는다.
+		odbcPool->Release(std::move(inFlight.connection), resultCode);
+
+		// 콜백에서 코루틴이 재개될 수 있으므로 연결을 반환한 후 마지막에 호출한다.
+		if (nullptr != inFlight.completion)
+		{
+			auto completion = std::move(inFlight.completion);
+			completion(resultCode, error);
+		}
+	}
+
+	static constexpr std::chrono::milliseconds IDLE_WAIT = std::chrono::milliseconds(100);
+
+	OdbcPoolTls m_odbcPoolTls;
+	_logging_ptr_t m_logging;
+
+	std::atomic_bool m_isRun = false;
+	std::atomic<size_t> m_inFlight = 0;
+	size_t m_maxInFlight = 64;
+	std::chrono::microseconds m_pollInterval = std::chrono::microseconds(200);
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Pending> m_queue;
+
+	std::vector<std::thread> m_threadGroup;
+};
+
+
+// DB 작업 실행기
+// 작업은 우선 순위(IQuery::ePriority)별 lock-free MPMC 큐(lane)로 전달되며 쓰레드별 OdbcPool의 연결로 동기 실행된다.
+// 각 쓰레드는 큐에서 꺼낸 작업을 lane별 deque에 보관하며 쉬는 쓰레드가 이를 훔쳐 실행한다.
+// (연결은 쓰레드 간에 이동하지 않고 작업만 이동한다.)
+// 쓰레드는 lane 가중치에 따라 확인할 lane을 정하며 해당 lane이 비어 있으면 우선 순위 순으로 다른 lane을 처리한다.
+// 예약된 쓰레드는 Critical lane만 처리하므로 대량 요청이 몰려도 Critical 요청이 뒤에서 기다리지 않는다.
+// affinity 키가 있는 작업은 키의 shard를 담당하는 쓰레드의 전용 큐로 전달되어 같은 키끼리는 순서대로 하나씩 실행된다.
+// (전용 큐는 훔치지 않으며 담당 쓰레드는 공용 lane보다 먼저 처리한다.)
+// 쉬는 쓰레드는 잠시 spin 후 대기하며 작업이 추가되면 즉시 깨어난다.
+class OdbcExecutor
+{
+public:
+	using _task_t = std::shared_ptr<IQuery>;
+	using _priority_t = IQuery::ePriority;
+
+	// lane별 처리 현황
+	struct LaneStats
 	{
-		if (true == m_stack.empty())
+		int64_t depth = 0;			// 대기 중인 작업 수
+		uint64_t executed = 0;		// 실행한 작업 수
+		uint64_t rejected = 0;		// 큐가 가득 차 거절된 작업 수
+		std::chrono::microseconds totalWait = std::chrono::microseconds(0);	// 실행까지 대기한 시간의 합
+		std::chrono::microseconds maxWait = std::chrono::microseconds(0);
+
+		inline std::chrono::microseconds GetAverageWait() const
+		{
+			return (0 == executed) ? std::chrono::microseconds(0) : totalWait / static_cast<int64_t>(executed);
+		}
+	};
+
+	OdbcExecutor(const OdbcConfiguration& configuration, size_t queueCapacity = DEFAULT_QUEUE_CAPACITY)
+		: m_shards(new std::atomic<uint64_t>[SHARD_COUNT])
+	{
+		m_odbcPoolTls.SetConfiguration(configuration);
+
+		for (size_t i = 0; i < LANE_COUNT; ++i)
+		{
+			m_lanes[i] = std::make_unique<Lane>(queueCapacity, DEFAULT_WEIGHTS[i]);
+		}
+	}
+
+	~OdbcExecutor()
+	{
+		Stop();
+
+		// 시작하지 않은 상태에서 남은 작업
+		FailPending();
+	}
+
+	void AttachLogging(_logging_ptr_t& logging)
+	{
+		m_logging = logging;
+	}
+
+	// 대기 전에 큐를 다시 확인하는 횟수
+	inline void SetSpinCount(int32_t count) { m_spinCount = (std::max)(count, 0); }
+
+	// lane을 선택하는 비율 (Start 전에 설정)
+	inline void SetLaneWeight(_priority_t priority, uint32_t weight) { m_lanes[ToLane(priority)]->weight = (std::clamp)(weight, static_cast<uint32_t>(1), MAX_WEIGHT); }
+
+	// Critical lane만 처리하는 쓰레드 수 (Start 전에 설정, 전체 쓰레드 수보다 최소 1개 적게 적용된다.)
+	inline void SetReservedWorkerCount(int32_t count) { m_reservedWorkerCount = (std::max)(count, 0); }
+
+	// 담당 쓰레드의 전용 큐에 이 값 이상 쌓이면 남은 작업이 없는 shard를 여유 있는 쓰레드로 옮긴다.
+	inline void SetRebalanceThreshold(int64_t threshold) { m_rebalanceThreshold = (std::max)(threshold, static_cast<int64_t>(1)); }
+
+	// 다른 쓰레드에서 훔쳐 실행한 작업 수
+	inline uint64_t GetStealCount() { return m_stealCount.load(std::memory_order_relaxed); }
+
+	// 담당 쓰레드가 변경된 shard 수
+	inline uint64_t GetRebalanceCount() { return m_rebalanceCount.load(std::memory_order_relaxed); }
+
+	LaneStats GetLaneStats(_priority_t priority)
+	{
+		return Snapshot(*m_lanes[ToLane(priority)], false);
+	}
+
+	// 마지막 호출 이후 누적된 통계를 반환하고 초기화한다. (depth 제외)
+	LaneStats TakeLaneStats(_priority_t priority)
+	{
+		return Snapshot(*m_lanes[ToLane(priority)], true);
+	}
+
+	bool Start(int32_t threadCount)
+	{
+		if (true == m_isRun.exchange(true))
+		{
+			return false;
+		}
+
+		m_isStopped = false;
+
+		BuildSchedule();
+
+		// 모든 쓰레드를 예약하면 다른 lane을 처리할 수 없으므로 최소 1개는 남긴다.
+		int32_t workerCount = (std::max)(threadCount, 1);
+		int32_t reservedCount = (std::min)(m_reservedWorkerCount, workerCount - 1);
+
+		// 훔치는 쓰레드가 모든 deque를 볼 수 있도록 쓰레드 시작 전에 생성한다.
+		for (int32_t i = 0; i < workerCount; ++i)
+		{
+			m_workers.emplace_back(std::make_unique<Worker>(this, m_workers.size(), i < reservedCount));
+		}
+
+		// 예약된 쓰레드는 Critical lane 전용이므로 shard를 담당하지 않는다.
+		for (size_t i = 0; i < SHARD_COUNT; ++i)
+		{
+			uint64_t owner = static_cast<uint64_t>(reservedCount) + (i % static_cast<size_t>(workerCount - reservedCount));
+			m_shards[i].store(owner << SHARD_OWNER_SHIFT, std::memory_order_relaxed);
+		}
+
+		for (auto& worker : m_workers)
+		{
+			m_threadGroup.emplace_back([this, w = worker.get()]() { Loop(*w); });
+		}
+
+		return true;
+	}
+
+	// 남은 작업을 모두 처리한 후 종료한다.
+	void Stop()
+	{
+		if (false == m_isRun.exchange(false))
+		{
+			return;
+		}
+
+		m_idle.Notify(true);
+		m_reservedIdle.Notify(true);
+
+		for (auto& t : m_threadGroup)
+		{
+			t.join();
+		}
+
+		m_threadGroup.clear();
+		m_workers.clear();
+
+		// 작업 쓰레드가 종료된 후에는 받지 않으며 그 사이에 들어온 작업은 실패 처리한다.
+		m_isStopped = true;
+		FailPending();
+	}
+
+	// 큐가 가득 찬 경우, 종료된 경우 false를 반환한다.
+	bool Put(_task_t task)
+	{
+		return Put(std::move(task), nullptr);
+	}
+
+	// 실행이 끝나면 연결을 반환한 후 completion을 호출한다.
+	// 작업 쓰레드에서 호출하면(completion 등) 해당 쓰레드의 deque에 바로 넣는다.
+	// 종료 중에는 affinity 키가 있어도 공용 lane으로 전달되며 순서를 보장하지 않는다.
+	bool Put(_task_t task, _query_completion_t completion)
+	{
+		size_t index = ToLane(task->GetPriority());
+		auto& lane = *m_lanes[index];
+
+		if (true == m_isStopped)
+		{
+			lane.rejected.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		uint64_t key = 0;
+		bool hasAffinity = (true == m_isRun && true == task->GetAffinityKey(key));
+
+		auto pending = std::make_unique<Pending>(Pending{ std::move(task), std::move(completion), index, std::chrono::steady_clock::now() });
+
+		// 꺼내는 쓰레드보다 먼저 증가시켜 음수가 되지 않도록 한다.
+		lane.depth.fetch_add(1, std::memory_order_relaxed);
+
+		if (true == hasAffinity)
+		{
+			if (false == PutAffinity(pending, key))
+			{
+				lane.depth.fetch_sub(1, std::memory_order_relaxed);
+				lane.rejected.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			// 담당 쓰레드를 지정하여 깨울 수 없으므로 쉬고 있는 쓰레드를 모두 깨운다.
+			m_idle.Notify(true);
+
+			return true;
+		}
+
+		auto worker = t_worker;
+		if (nullptr != worker && this == worker->owner && true == IsServing(*worker, index) && true == worker->tasks[index]->TryPush(pending.get()))
+		{
+			pending.release();
+		}
+		else if (true == lane.queue.TryPut(pending.get()))
+		{
+			pending.release();
+		}
+		else
+		{
+			lane.depth.fetch_sub(1, std::memory_order_relaxed);
+			lane.rejected.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		Notify(index);
+
+		return true;
+	}
+
+private:
+	static constexpr size_t LANE_COUNT = static_cast<size_t>(_priority_t::Max);
+	static constexpr size_t CRITICAL_LANE = static_cast<size_t>(_priority_t::Critical);
+	static constexpr size_t NORMAL_LANE = static_cast<size_t>(_priority_t::Normal);
+
+	// Critical : Normal : Bulk
+	static constexpr std::array<uint32_t, LANE_COUNT> DEFAULT_WEIGHTS = { 8, 4, 1 };
+	static constexpr uint32_t MAX_WEIGHT = 64;
+
+	// shard 상태 (상위 32bit : 담당 쓰레드, 하위 32bit : 대기 및 실행 중인 작업 수)
+	static constexpr size_t SHARD_COUNT = 1024;
+	static constexpr uint32_t SHARD_OWNER_SHIFT = 32;
+	static constexpr uint64_t SHARD_PENDING_MASK = 0xFFFFFFFF;
+
+	struct Pending
+	{
+		_task_t task;
+		_query_completion_t completion;
+		size_t lane;
+		std::chrono::steady_clock::time_point enqueueTime;
+
+		// affinity 키가 있는 작업의 shard
+		std::atomic<uint64_t>* shard = nullptr;
+	};
+
+	struct Lane
+	{
+		Lane(size_t capacity, uint32_t weight_)
+			: queue(capacity)
+			, weight(weight_)
+		{
+		}
+
+		MpmcQueue<Pending*> queue;
+		uint32_t weight;
+
+		std::atomic<int64_t> depth = 0;
+		std::atomic<uint64_t> executed = 0;
+		std::atomic<uint64_t> rejected = 0;
+		std::atomic<int64_t> totalWait = 0;	// us
+		std::atomic<int64_t> maxWait = 0;	// us
+	};
+
+	struct Worker
+	{
+		Worker(OdbcExecutor* owner_, size_t index_, bool reserved_)
+			: owner(owner_)
+			, index(index_)
+			, reserved(reserved_)
+			, affinity(AFFINITY_QUEUE_CAPACITY)
+		{
+			for (auto& deque : tasks)
+			{
+				deque = std::make_unique<WorkStealingDeque<Pending>>(LOCAL_QUEUE_CAPACITY);
+			}
+		}
+
+		OdbcExecutor* owner;
+		size_t index;
+		bool reserved;
+
+		// 가중치 순서(m_schedule)에서 다음에 확인할 위치
+		size_t turn = 0;
+
+		std::array<std::unique_ptr<WorkStealingDeque<Pending>>, LANE_COUNT> tasks;
+
+		// 담당 shard의 작업 (이 쓰레드만 꺼낸다.)
+		MpmcQueue<Pending*> affinity;
+		std::atomic<int64_t> affinityDepth = 0;
+	};
+
+	using _pool_ptr_t = OdbcPoolTls::_value_t;
+
+	static constexpr size_t DEFAULT_QUEUE_CAPACITY = 4096;
+	static constexpr size_t LOCAL_QUEUE_CAPACITY = 256;
+	static constexpr size_t MAX_BULK_COUNT = 32;
+	static constexpr size_t AFFINITY_QUEUE_CAPACITY = 1024;
+
+	static size_t ToLane(_priority_t priority)
+	{
+		size_t index = static_cast<size_t>(priority);
+		return (LANE_COUNT <= index) ? NORMAL_LANE : index;
+	}
+
+	// 종료 중에는 남은 작업을 모두 처리하기 위해 예약된 쓰레드도 모든 lane을 처리한다.
+	inline bool IsServing(Worker& worker, size_t lane)
+	{
+		return (false == worker.reserved || CRITICAL_LANE == lane || false == m_isRun);
+	}
+
+	// 연속된 키(usn 등)가 같은 shard에 몰리지 않도록 섞는다. (splitmix64)
+	static uint64_t MixKey(uint64_t key)
+	{
+		key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+		key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+		return key ^ (key >> 31);
+	}
+
+	bool PutAffinity(std::unique_ptr<Pending>& pending, uint64_t key)
+	{
+		auto& shard = m_shards[MixKey(key) & (SHARD_COUNT - 1)];
+		pending->shard = &shard;
+
+		// 작업 수를 증가시키며 담당 쓰레드를 함께 읽으므로 옮기는 중인 shard와 순서가 꼬이지 않는다.
+		uint64_t state = shard.fetch_add(1, std::memory_order_acq_rel) + 1;
+		size_t owner = static_cast<size_t>(state >> SHARD_OWNER_SHIFT);
+
+		// 남은 작업이 없는 shard만 옮길 수 있다.
+		if (1 == (state & SHARD_PENDING_MASK) && m_rebalanceThreshold <= m_workers[owner]->affinityDepth.load(std::memory_order_relaxed))
+		{
+			size_t target = FindLeastLoaded();
+			if (target != owner && m_workers[target]->affinityDepth.load(std::memory_order_relaxed) < m_rebalanceThreshold / 2)
+			{
+				uint64_t moved = (static_cast<uint64_t>(target) << SHARD_OWNER_SHIFT) | 1;
+				if (true == shard.compare_exchange_strong(state, moved, std::memory_order_acq_rel))
+				{
+					owner = target;
+					m_rebalanceCount.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		auto& worker = *m_workers[owner];
+		worker.affinityDepth.fetch_add(1, std::memory_order_relaxed);
+		if (false == worker.affinity.TryPut(pending.get()))
 		{
+			worker.affinityDepth.fetch_sub(1, std::memory_order_relaxed);
+			shard.fetch_sub(1, std::memory_order_acq_rel);
 			return false;
 		}
 
-		task = m_stack.back();
-		m_stack.pop_back();
+		pending.release();
+
+		return true;
+	}
+
+	size_t FindLeastLoaded()
+	{
+		size_t selected = m_workers.size() - 1;
+		for (size_t i = 0; i < m_workers.size(); ++i)
+		{
+			if (true == m_workers[i]->reserved)
+			{
+				continue;
+			}
+
+			if (m_workers[i]->affinityDepth.load(std::memory_order_relaxed) < m_workers[selected]->affinityDepth.load(std::memory_order_relaxed))
+			{
+				selected = i;
+			}
+		}
+
+		return selected;
+	}
+
+	// 가중치 비율대로 lane이 고르게 섞인 순서를 만든다. (smooth weighted round robin)
+	void BuildSchedule()
+	{
+		std::array<int64_t, LANE_COUNT> current = {};
+		int64_t total = 0;
+		for (auto& lane : m_lanes)
+		{
+			total += lane->weight;
+		}
+
+		m_schedule.clear();
+		for (int64_t n = 0; n < total; ++n)
+		{
+			size_t selected = 0;
+			for (size_t i = 0; i < LANE_COUNT; ++i)
+			{
+				current[i] += m_lanes[i]->weight;
+				if (current[selected] < current[i])
+				{
+					selected = i;
+				}
+			}
+
+			current[selected] -= total;
+			m_schedule.push_back(static_cast<uint8_t>(selected));
+		}
+	}
+
+	void Loop(Worker& worker)
+	{
+		t_worker = &worker;
+
+		auto odbcPool = m_odbcPoolTls.Create();
+		if (false == odbcPool->HasLogging() && nullptr != m_logging)
+		{
+			odbcPool->AttachLogging(m_logging);
+		}
+
+		while (true)
+		{
+			auto pending = Next(worker);
+			if (nullptr == pending)
+			{
+				if (false == Idle(worker))
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			Execute(odbcPool, *pending);
+
+			if (nullptr != pending->shard)
+			{
+				pending->shard->fetch_sub(1, std::memory_order_acq_rel);
+			}
+
+			delete pending;
+		}
+
+		m_odbcPoolTls.Destroy();
+
+		t_worker = nullptr;
+	}
+
+	// 실행되지 못한 작업의 completion에 실패를 전달한다. (코루틴이 재개되도록)
+	void FailPending()
+	{
+		for (auto& lane : m_lanes)
+		{
+			Pending* pending = nullptr;
+			while (true == lane->queue.TryPop(pending))
+			{
+				lane->depth.fetch_sub(1, std::memory_order_relaxed);
+
+				if (nullptr != pending->completion)
+				{
+					_odbc_error_ptr_t error;
+					pending->completion(SQL_ERROR, error);
+				}
 
-		return true;
+				delete pending;
+			}
+		}
 	}
 
-	virtual void Put(_element_t&& task) override 
+	// 가중치 순서로 정해진 lane을 먼저 확인하고 비어 있으면 우선 순위 순으로 다른 lane을 확인한다.
+	Pending* Next(Worker& worker)
 	{
-		m_stack.push_back(std::forward<_element_t>(task));
-	}
+		Pending* affinity = nullptr;
+		if (true == worker.affinity.TryPop(affinity))
+		{
+			worker.affinityDepth.fetch_sub(1, std::memory_order_relaxed);
+			return affinity;
+		}
 
-private:
-	std::deque<_element_t> m_stack; //  .
-};
+		size_t first = m_schedule[worker.turn++ % m_schedule.size()];
+		if (false == IsServing(worker, first))
+		{
+			first = CRITICAL_LANE;
+		}
 
-struct OdbcConfiguration
-{
-	std::string connectionString;
-	int32_t maxOdbcCount = 0;
-};
+		auto pending = Take(worker, first);
+		for (size_t lane = 0; nullptr == pending && lane < LANE_COUNT; ++lane)
+		{
+			if (first == lane || false == IsServing(worker, lane))
+			{
+				continue;
+			}
 
-// DB  ü մϴ.(ODBC Pool)
-//  ..
-// 1. TLS 庰 
-// 2. Ƽ  ȯ濡  ϵ ó
-template <typename Queue>
-class OdbcPool
-{
-	static_assert(std::is_base_of_v<IQueue<std::shared_ptr<Odbc>>, Queue>, "A Queue had not inherit a IQueue class.");
+			pending = Take(worker, lane);
+		}
 
-public:
-	OdbcPool() 
-		: m_pool(new Queue)
-	{
+		return pending;
 	}
 
-	inline bool HasLogging() 
+	Pending* Take(Worker& worker, size_t lane)
 	{
-		return (nullptr != m_logging);
-	}
+		auto pending = worker.tasks[lane]->TryPop();
+		if (nullptr == pending)
+		{
+			pending = Refill(worker, lane);
+		}
 
-	void AttachLogging(_logging_ptr_t& logging)
-	{
-		m_logging = logging;
-	}
+		if (nullptr == pending)
+		{
+			pending = Steal(worker, lane);
+		}
 
-	void DetachLogging()
-	{
-		m_logging = nullptr;
+		return pending;
 	}
 
-	bool Initialize(const OdbcConfiguration& configuration)
+	// 공용 큐에서 작업을 한번에 꺼내 자신의 deque에 보관하고 하나를 반환한다.
+	Pending* Refill(Worker& worker, size_t lane)
 	{
-		m_configuration = configuration;
+		std::array<Pending*, MAX_BULK_COUNT> tasks;
 
-		m_isRun = true;
+		auto& queue = m_lanes[lane]->queue;
+		auto& deque = *worker.tasks[lane];
 
-		return true;
-	}
+		size_t count = queue.TryPopBulk(tasks.data(), tasks.size());
+		if (0 == count)
+		{
+			return nullptr;
+		}
 
-	void Finalize()
-	{
-		m_isRun = false;
+		// 자신은 먼저 들어온 작업부터 실행하도록 역순으로 넣는다. (뒤쪽 작업을 다른 쓰레드가 훔쳐감)
+		for (size_t i = count - 1; 0 < i; --i)
+		{
+			if (false == deque.TryPush(tasks[i]))
+			{
+				// 자신의 작업이 이미 가득 찬 경우 공용 큐로 되돌린다.
+				while (false == queue.TryPut(tasks[i]))
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
 
-		CleanUp();
+		if (1 < count)
+		{
+			Notify(lane);
+		}
+
+		return tasks[0];
 	}
 
-	//   մϴ.
-	void CleanUp()
+	Pending* Steal(Worker& worker, size_t lane)
 	{
-		//   ʰ ִ ͵... ó
-		while (true)
+		size_t workerCount = m_workers.size();
+		for (size_t i = 1; i < workerCount; ++i)
 		{
-			std::shared_ptr<Odbc> odbc;
-			if (false == m_pool->TryPop(odbc))
+			auto& victim = m_workers[(worker.index + i) % workerCount]->tasks[lane];
+
+			auto pending = victim->TrySteal();
+			if (nullptr != pending)
 			{
-				break;
+				m_stealCount.fetch_add(1, std::memory_order_relaxed);
+
+				// 남은 작업이 있으면 다른 쉬는 쓰레드도 깨운다.
+				if (false == victim->IsEmpty())
+				{
+					Notify(lane);
+				}
+
+				return pending;
 			}
+		}
 
-			odbc->CleanUp();
-			odbc.reset();
+		return nullptr;
+	}
 
-			m_monitor.Cleanup();
+	// Critical 작업은 예약된 쓰레드와 일반 쓰레드 모두 처리할 수 있다.
+	void Notify(size_t lane)
+	{
+		if (CRITICAL_LANE == lane)
+		{
+			m_reservedIdle.Notify();
 		}
+
+		m_idle.Notify();
 	}
 
-	// CleanUp ȣǸ nullptr ȯѴ.
-	std::shared_ptr<Odbc> GetConnection()
+	bool HasTask(Worker& worker)
 	{
-		if (false == m_isRun)
+		if (false == worker.affinity.IsEmpty())
 		{
-			return nullptr;
+			return true;
 		}
 
-		std::shared_ptr<Odbc> odbc;
-		if (false == m_pool->TryPop(odbc))
+		for (size_t lane = 0; lane < LANE_COUNT; ++lane)
 		{
-			if (0 < m_configuration.maxOdbcCount && m_configuration.maxOdbcCount <= m_monitor.GetTotal())
+			if (false == IsServing(worker, lane))
 			{
-				OnLog<ILogging::eLevel::Warning>(__FUNCTION__, __LINE__, "A new connection can not create because over max connection.");
-				return nullptr;
+				continue;
 			}
 
-			odbc.reset(new Odbc);
-
-			if (false == odbc->Setup(m_configuration.connectionString.c_str(), m_logging))
+			if (false == m_lanes[lane]->queue.IsEmpty())
 			{
-				return nullptr;
+				return true;
 			}
 
-			m_monitor.Create();
+			for (auto& other : m_workers)
+			{
+				if (false == other->tasks[lane]->IsEmpty())
+				{
+					return true;
+				}
+			}
 		}
 
-		//   
-		odbc->SetState(Odbc::eState::Used);
-
-		m_monitor.Allocate();
-
-		return odbc;
+		return false;
 	}
 
-	void Release(std::shared_ptr<Odbc>&& odbc)
+	// 작업이 추가될 때까지 spin 후 대기한다. 종료 상태이며 남은 작업이 없으면 false
+	bool Idle(Worker& worker)
 	{
-		// Used -> Free    . 
-		// Atomic compare_exchange_strong ó 
-		if (false == odbc->SetFreeState())
+		for (int32_t i = 0; i < m_spinCount; ++i)
 		{
-			return;
+			if (true == HasTask(worker))
+			{
+				return true;
+			}
+
+			std::this_thread::yield();
 		}
 
-		if (false == m_isRun)
+		auto& idle = (true == worker.reserved) ? m_reservedIdle : m_idle;
+
+		auto epoch = idle.PrepareWait();
+		if (true == HasTask(worker))
 		{
-			// Ѵ.
-			odbc->CleanUp();
-			odbc.reset();
+			idle.CancelWait();
+			return true;
+		}
 
-			m_monitor.ReleaseAndCleanup();
-			return;
+		if (false == m_isRun)
+		{
+			idle.CancelWait();
+			return false;
 		}
 
-		m_pool->Put(std::forward<std::shared_ptr<Odbc>>(odbc));
+		idle.Wait(epoch);
 
-		m_monitor.Release();
+		return true;
 	}
 
-private:
-	template <ILogging::eLevel level, typename... Args>
-	void OnLog(const char* function, int32_t line, std::string_view format, Args... args)
+	void Execute(_pool_ptr_t& odbcPool, Pending& pending)
 	{
-		if (nullptr == m_logging)
+		OnDequeue(*m_lanes[pending.lane], pending);
+
+		// 연결할 수 없거나 재시도 후에도 실패한 경우 실패로 완료한다.
+		_odbc_error_ptr_t error;
+		SQLRETURN resultCode = odbcPool->Execute(pending.task.get(), error);
+
+		if (nullptr != pending.completion)
 		{
-			return;
+			pending.completion(resultCode, error);
 		}
+	}
 
-		// TODO:: ostream ӹ޾  fmt !
-		std::stringstream ss;
-		ss << "[" << NamedLoggingLevel<level>::Name() << "][" << function << "(" << line << ")][" << format << "]";
+	// 실행을 시작하는 작업의 대기 시간을 기록한다.
+	void OnDequeue(Lane& lane, Pending& pending)
+	{
+		int64_t wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pending.enqueueTime).count();
 
-		std::string message = ss.str();
+		lane.depth.fetch_sub(1, std::memory_order_relaxed);
+		lane.executed.fetch_add(1, std::memory_order_relaxed);
+		lane.totalWait.fetch_add(wait, std::memory_order_relaxed);
 
-		switch (level)
+		int64_t maxWait = lane.maxWait.load(std::memory_order_relaxed);
+		while (maxWait < wait && false == lane.maxWait.compare_exchange_weak(maxWait, wait, std::memory_order_relaxed))
 		{
-		case ILogging::eLevel::Trace:
-			m_logging->Trace(message);
-			break;
-		case ILogging::eLevel::Debug:
-			m_logging->Debug(message);
-			break;
-		case ILogging::eLevel::Info:
-			m_logging->Info(message);
-			break;
-		case ILogging::eLevel::Warning:
-			m_logging->Warning(message);
-			break;
-		case ILogging::eLevel::Error:
-			m_logging->Error(message);
-			break;
-		default:
-			break;
 		}
 	}
 
-	//   Manager ٸ..?? 
-	//  ???
-	//   ü    Ȳ ͸   ִ  ʿϴ.
-	// ᱹ ͸ Ʈ ȭ   ̸ Ƽ ޾ƾѴ.
-
-
-	// ODBC ü  Ȳ üũϱ   ü
-	class Monitor
+	LaneStats Snapshot(Lane& lane, bool reset)
 	{
-	public:
-		inline int32_t GetTotal() { return m_total; }
-		inline int32_t GetUsed() { return m_used; }
-		inline int32_t GetFree() { return m_free; }
-
-		void Create() { ++m_total; ++m_free; }
-		void Allocate() { --m_free; ++m_used; }
-		void Release() { ++m_free; --m_used; }
-		void Cleanup() { --m_total; --m_free; }
-		void ReleaseAndCleanup() { Release(); Cleanup(); }
+		LaneStats stats;
+		stats.depth = lane.depth.load(std::memory_order_relaxed);
 
-		// Ȳ ȯѴ. 
-		// ) 0 total, 0 free, 0 used
-		std::string ToString() 
+		if (true == reset)
 		{
-			return "";
+			stats.executed = lane.executed.exchange(0, std::memory_order_relaxed);
+			stats.rejected = lane.rejected.exchange(0, std::memory_order_relaxed);
+			stats.totalWait = std::chrono::microseconds(lane.totalWait.exchange(0, std::memory_order_relaxed));
+			stats.maxWait = std::chrono::microseconds(lane.maxWait.exchange(0, std::memory_order_relaxed));
+		}
+		else
+		{
+			stats.executed = lane.executed.load(std::memory_order_relaxed);
+			stats.rejected = lane.rejected.load(std::memory_order_relaxed);
+			stats.totalWait = std::chrono::microseconds(lane.totalWait.load(std::memory_order_relaxed));
+			stats.maxWait = std::chrono::microseconds(lane.maxWait.load(std::memory_order_relaxed));
 		}
 
-	private:
-		std::atomic_int32_t m_total = 0;
-		std::atomic_int32_t m_used = 0;
-		std::atomic_int32_t m_free = 0;
-	};
-	
-	Monitor m_monitor;
-
-	std::atomic_bool m_isRun = false;
+		return stats;
+	}
 
-	OdbcConfiguration m_configuration;
+	// 현재 쓰레드가 실행 중인 작업 쓰레드
+	static inline thread_local Worker* t_worker = nullptr;
 
+	OdbcPoolTls m_odbcPoolTls;
 	_logging_ptr_t m_logging;
 
-	std::shared_ptr<IQueue<std::shared_ptr<Odbc>>> m_pool;
+	std::atomic_bool m_isRun = false;
+	std::atomic_bool m_isStopped = false;
+	int32_t m_spinCount = 64;
+	int32_t m_reservedWorkerCount = 0;
+	int64_t m_rebalanceThreshold = 64;
+	std::atomic<uint64_t> m_stealCount = 0;
+	std::atomic<uint64_t> m_rebalanceCount = 0;
+
+	std::array<std::unique_ptr<Lane>, LANE_COUNT> m_lanes;
+	std::vector<uint8_t> m_schedule;
+	std::unique_ptr<std::atomic<uint64_t>[]> m_shards;
+
+	// 일반 쓰레드와 예약된 쓰레드를 따로 깨운다.
+	EventCount m_idle;
+	EventCount m_reservedIdle;
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threadGroup;
 };
 
-// 庰 OdbcPool ϱ  ü
-class OdbcPoolTls
-{
-public:
-	using _key_t = std::thread::id;
-	using _value_t = std::shared_ptr<OdbcPool<NonThreadSafeQueue>>;
-	using _container_t = std::map<_key_t, _value_t>;
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
 
-	void SetConfiguration(const OdbcConfiguration& configuration)
-	{
-		m_configuration = configuration;
-	}
+// 코루틴에서 받는 쿼리 실행 결과
+template <typename DAO>
+struct QueryResult
+{
+	SQLRETURN resultCode = SQL_ERROR;
 
-	_value_t Create()
-	{
-		std::unique_lock<std::shared_mutex> lock(m_mutex);
+	// Parse, Process가 끝난 DAO (쿼리가 소유한다.)
+	DAO* dao = nullptr;
 
-		auto itr = m_container.find(std::this_thread::get_id());
-		if (m_container.end() != itr)
-		{
-			return itr->second;
-		}
+	// 실패 시 에러 (없을 경우 nullptr)
+	_odbc_error_ptr_t error;
 
-		auto obj = std::make_shared<OdbcPool<NonThreadSafeQueue>>();
-		obj->Initialize(m_configuration);
+	inline bool IsSuccess() const { return (SQL_SUCCESS == resultCode); }
+};
 
-		m_container.emplace(std::this_thread::get_id(), obj);
+// co_await ExecuteAsync(reactor, query)
+// 코루틴을 중단하고 실행기 쓰레드에서 쿼리를 실행한 후 실행기 쓰레드에서 코루틴을 재개한다.
+// Executor는 Put(std::shared_ptr<IQuery>, _query_completion_t)를 제공해야 한다.
+template <typename Executor, typename QueryT>
+class QueryAwaiter
+{
+public:
+	using _dao_t = typename QueryT::_dao_t;
 
-		return obj;
+	QueryAwaiter(Executor& executor, std::shared_ptr<QueryT> query)
+		: m_executor(executor), m_query(std::move(query))
+	{
 	}
 
-	_value_t Lookup()
-	{
-		std::shared_lock<std::shared_mutex> lock(m_mutex);
+	inline bool await_ready() noexcept { return false; }
 
-		auto itr = m_container.find(std::this_thread::get_id());
-		if (m_container.end() == itr)
+	// Put이 bool을 반환하는 실행기(OdbcExecutor)는 큐가 가득 차 거절되면 completion을 호출하지 않으므로
+	// 중단하지 않고 SQL_ERROR(error는 nullptr)로 바로 재개한다.
+	bool await_suspend(std::coroutine_handle<> handle)
+	{
+		_query_completion_t completion = [this, handle](SQLRETURN resultCode, _odbc_error_ptr_t& error)
 		{
-			return nullptr;
-		}
-
-		return itr->second;
-	}
+			m_result.resultCode = resultCode;
+			m_result.dao = static_cast<_dao_t*>(m_query->GetDao());
+			m_result.error = error;
 
-	void Destroy()
-	{
-		std::unique_lock<std::shared_mutex> lock(m_mutex);
+			handle.resume();
+		};
 
-		auto itr = m_container.find(std::this_thread::get_id());
-		if (m_container.end() != itr)
+		// Put이 반환된 후에는 다른 쓰레드에서 이미 재개되었을 수 있으므로 멤버에 접근하지 않는다.
+		if constexpr (std::is_same_v<decltype(m_executor.Put(m_query, std::move(completion))), bool>)
 		{
-			itr->second->Finalize();
-			m_container.erase(itr);
+			if (false == m_executor.Put(m_query, std::move(completion)))
+			{
+				m_result.resultCode = SQL_ERROR;
+				m_result.dao = static_cast<_dao_t*>(m_query->GetDao());
+				return false;
+			}
 		}
-	}
-
-	template <typename Func>
-	void Traverse(Func&& func)
-	{
-		std::shared_lock<std::shared_mutex> lock(m_mutex);
-
-		for (const auto& [key, value] : m_container)
+		else
 		{
-			func(key, value);
+			m_executor.Put(m_query, std::move(completion));
 		}
+
+		return true;
 	}
 
+	QueryResult<_dao_t> await_resume() { return std::move(m_result); }
+
 private:
-	std::shared_mutex m_mutex;
-	OdbcConfiguration m_configuration;
-	_container_t m_container;
-};
\ No newline at end of file
+	Executor& m_executor;
+	std::shared_ptr<QueryT> m_query;
+	QueryResult<_dao_t> m_result;
+};
+
+template <typename Executor, typename QueryT>
+QueryAwaiter<Executor, QueryT> ExecuteAsync(Executor& executor, std::shared_ptr<QueryT> query)
+{
+	return QueryAwaiter<Executor, QueryT>(executor, std::move(query));
+}
+
+#endif
\ No newline at end of file
@@ -53,19 +53,11 @@ public:
 	// 1개 이상의 row를 받았을 경우 처리
 	virtual bool Parse(Statement* statement) override
 	{
-		std::string expireTime;
+		// 결과 컨테이너는 실행 단위 arena(OdbcConfiguration::arenaSize)에서 할당되며 Process 이후 한번에 해제된다.
+		std::pmr::vector<element> results(GetMemoryResource());
 
-		std::vector<element> results;
-
-		do
-		{
-			element elem;
-			statement->ReadData(elem.type);
-			statement->ReadData(elem.info);
-			statement->ReadData(elem.expiretime);
-
-			results.emplace_back(elem);
-		} while (true == statement->MoveNext());
+		// 컬럼 순서대로 멤버를 나열하면 row-wise 바인딩으로 블록 단위로 읽는다.
+		RowSchema<&element::type, &element::info, &element::expiretime>::Read(statement, results);
 
 		return true;
 	}
@@ -225,6 +217,16 @@ public:
 		std::cout << __FUNCTION__ << std::endl;
 	}
 
+	// 풀에서 재사용되기 전에 이전 결과를 정리
+	virtual void Reset() override
+	{
+		m_spResult = SP_RESULT{};
+		m_userInfo = TB_G_USER_INFO{};
+		m_userSlotList.clear();
+		m_characters.clear();
+		m_characterPresetList.clear();
+	}
+
 private:
 	SP_RESULT m_spResult;
 	TB_G_USER_INFO m_userInfo;
@@ -241,150 +243,41 @@ public:
 	using _query_P_GAME_DAILY_ACHIEVEMENT_R = std::shared_ptr<Query<P_GAME_DAILY_ACHIEVEMENT_R, int64_t, std::string>>;
 	static _query_P_GAME_DAILY_ACHIEVEMENT_R CreateP_GAME_DAILY_ACHIEVEMENT_R()
 	{
-		// 객체 생성 시 Query 작성
-		return std::make_shared<Query<P_GAME_DAILY_ACHIEVEMENT_R, int64_t, std::string>>(
+		// 풀에서 재사용되는 객체를 받으며 마지막 참조가 해제되면 풀로 반환된다.
+		static QueryPool<Query<P_GAME_DAILY_ACHIEVEMENT_R, int64_t, std::string>> pool(
 			"{ call P_GAME_DAILY_ACHIEVEMENT_R(?, ?) }"
 			);
+
+		return pool.Acquire();
 	}
 
+	// 길이가 짧은 문자열 파라미터는 FixedString으로 선언하면 힙 할당 없이 보관된다.
 	using _query_P_GAME_LoginData_MARS_RU_t = Query<P_GAME_LoginData_MARS_RU,
 		uint8_t,
 		int64_t,
-		std::string,
+		FixedString<32>,
 		int32_t,
-		std::string,
-		std::string,
-		std::string,
-		std::string>;
+		FixedString<32>,
+		FixedString<16>,
+		FixedString<8>,
+		FixedString<8>>;
 
-	static _query_P_GAME_LoginData_MARS_RU_t* CreateP_GAME_LoginData_MARS_RU()
+	static std::shared_ptr<_query_P_GAME_LoginData_MARS_RU_t> CreateP_GAME_LoginData_MARS_RU()
 	{
-		return new _query_P_GAME_LoginData_MARS_RU_t(
+		static QueryPool<_query_P_GAME_LoginData_MARS_RU_t> pool(
 			"{ call P_GAME_LoginData_MARS_RU(?,?,?,?,?,?,?,?) }"
 		);
-	}
-};
-
-#include <queue>
-
-class TlsWorkerThread
-{
-public:
-	TlsWorkerThread(OdbcConfiguration& config) 
-	{
-		m_odbcPoolTls.SetConfiguration(config);
-	}
-
-	void Run() 
-	{
-		for (int32_t i = 0; i < 1; ++i)
-		{
-			m_threadGroup.emplace_back(
-				[this]()
-				{
-					auto odbcPool = m_odbcPoolTls.Create();
-					if (false == odbcPool->HasLogging())
-					{
-						odbcPool->AttachLogging(m_logging);
-					}
-
-					/*
-					/////////////////////////////////////////////////////////////
-					// Queue를 통해 전달된 Task
-					int64_t usn = 1000121111200000002;
-					std::string datetime = "2022-03-23 12:12:12";
-
-					auto query = NamedQuery::CreateP_GAME_DAILY_ACHIEVEMENT_R();
-					query->SetParameter(usn, datetime);
-					/////////////////////////////////////////////////////////////
-					*/
-
-					while (true)
-					{
-						std::shared_ptr<IQuery> query;
-						if (false == TryPop(query))
-						{
-							std::this_thread::sleep_for(std::chrono::milliseconds(10));
-							continue;
-						}
-
-						if (nullptr == query)
-						{
-							break;
-						}
-
-						do
-						{
-							auto connection = odbcPool->GetConnection();
-							if (nullptr == connection)
-							{
-								// 네트웍 또는 장비 이슈로 인해 연결을 할수 없는 상태라면?? 
-
-								break;
-							}
-
-							// 질의 정보를 등록
-							connection->BindQuery(query.get());
-							auto executeResultCode = connection->Execute();
-							if (SQL_SUCCESS != executeResultCode)
-							{
-								odbcPool->CleanUp(); // 해당 객체에 문제가 있다면 나머지를 모두 날린다.
-								continue;
-							}
-
-							odbcPool->Release(std::move(connection));
-
-							break; // 정상처리되었으므로 종료
-						} while (true);
-
-						std::this_thread::sleep_for(std::chrono::seconds(1));
-					}
-
-					m_odbcPoolTls.Destroy();
-				}
-			);
-		}
-	}
-
-	void Put(std::shared_ptr<IQuery> task)
-	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		m_queue.push(task);
-	}
 
-	bool TryPop(std::shared_ptr<IQuery>& task)
-	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		if (true == m_queue.empty())
-		{
-			return false;
-		}
-
-		task = m_queue.front();
-		m_queue.pop();
+		auto query = pool.Acquire();
 
-		return true;
-	}
+		// 캐릭터/프리셋 레코드셋은 row 수가 많으므로 블록 단위로 읽는다.
+		query->SetRowArraySize(256);
 
-	void Stop()
-	{
-		Put(nullptr);
+		// 로그인은 지연에 민감하므로 실행기의 Critical lane으로 처리한다.
+		query->SetPriority(IQuery::ePriority::Critical);
 
-		for (auto& t : m_threadGroup)
-		{
-			t.join();
-		}
+		return query;
 	}
-
-private:
-	OdbcPoolTls m_odbcPoolTls;
-
-	_logging_ptr_t m_logging = std::make_shared<Logging>();
-
-	std::mutex m_mutex;
-	std::queue<std::shared_ptr<IQuery>> m_queue;
-
-	std::vector<std::thread> m_threadGroup;
 };
 
 int main() 
@@ -393,7 +286,18 @@ int main()
 	config.connectionString = "Driver={ODBC Driver 17 for SQL Server};Server=tcp:172.31.101.38,1433;Database=MFR_GAME;Uid=MFRServerUser;Pwd=1234;language=english;ConnectRetryCount=0;";
 	config.maxOdbcCount = 10;
 
-	TlsWorkerThread twh(config);
+	// 실행기 쓰레드별로 미리 연결해 둘 연결 수
+	config.minIdleCount = 2;
+
+	// DAO 결과 컨테이너를 실행 단위 arena에서 할당한다.
+	config.arenaSize = 64 * 1024;
+
+	_logging_ptr_t logging = std::make_shared<Logging>();
+
+	// 쓰레드별 OdbcPool을 가진 작업 실행기
+	OdbcExecutor executor(config);
+	executor.AttachLogging(logging);
+	executor.Start(1);
 	
 	for (int32_t i = 0; i < 10; ++i)
 	{
@@ -406,10 +310,15 @@ int main()
 			datetime
 		);
 
-		twh.Put(query);
+		// 같은 유저의 요청은 실행기에서 순서대로 처리된다.
+		query->SetAffinityKey(static_cast<uint64_t>(usn));
+
+		// 큐가 가득 찼거나 종료된 경우 실행되지 않는다.
+		if (false == executor.Put(query))
+		{
+			logging->Error("P_GAME_DAILY_ACHIEVEMENT_R is rejected by the executor.");
+		}
 	}
-	
-	twh.Run();
 
 	/*
 	// 1. ODBC 매니저 초기화 및 Connection 획득
@@ -420,67 +329,55 @@ int main()
 	odbcManager.AttachLogging(logging);
 	odbcManager.Initialize("Driver={ODBC Driver 17 for SQL Server};Server=tcp:172.31.101.38,1433;Database=MFR_GAME;Uid=MFRServerUser;Pwd=1234;language=english;ConnectRetryCount=0;", 100);
 
-	// 2. P_GAME_DAILY_ACHIEVEMENT_R 실행
+	// 2. P_GAME_DAILY_ACHIEVEMENT_R 실행 (연결을 직접 받아 실행)
 	{
-		do
-		{
-			int64_t usn = 1000121111200000002;
-			std::string datetime = "2022-03-23 12:12:12";
-
-			auto query = NamedQuery::CreateP_GAME_DAILY_ACHIEVEMENT_R();
-			query->SetParameter(usn, datetime);
+		int64_t usn = 1000121111200000002;
+		std::string datetime = "2022-03-23 12:12:12";
 
-			auto connection = odbcManager.GetConnection();
-			if (nullptr == connection)
-			{
-				// 네트웍 또는 장비 이슈로 인해 연결을 할수 없는 상태라면?? 
+		auto query = NamedQuery::CreateP_GAME_DAILY_ACHIEVEMENT_R();
+		query->SetParameter(usn, datetime);
 
-				break;
-			}
+		auto connection = odbcManager.GetConnection();
+		if (nullptr != connection)
+		{
 			// 질의 정보를 등록
-			connection->BindQuery(query);
+			connection->BindQuery(query.get());
 			auto executeResultCode = connection->Execute();
-			if (SQL_SUCCESS != executeResultCode)
-			{
-				odbcManager.CleanUp(); // 해당 객체에 문제가 있다면 나머지를 모두 날린다.
-				continue;
-			}
 
-			odbcManager.Release(std::move(connection));
-
-			break; // 정상처리되었으므로 종료
-		} while (true);
+			// 연결 문제(Critical)인 경우 해당 연결만 종료되며 나머지는 다음 사용 시 확인된다.
+			odbcManager.Release(std::move(connection), executeResultCode);
+		}
 	}
 
 	// 3. P_GAME_LoginData_MARS_RU 실행
+	// 연결 획득, 실행, 반환을 한번에 처리하며 실패 시 재시도 정책(데드락, 연결 문제 등)에 따라 정해진 횟수만 다시 실행한다.
+	// 실행한 후의 실패는 다시 실행해도 되는 쿼리(SetIdempotent(true), DAO의 Reset 구현 필요)만 재시도한다.
 	{
-		do
+		uint8_t loginMode = 0;
+		int64_t usn = 0;
+		std::string pid = "OTEST2020";
+		int32_t serverID = 1001;
+		std::string serverTime = "2022-03-23 12:12:12";
+		std::string platform = "iOS";
+		std::string country = "Kr";
+		std::string languageCode = "Ko";
+
+		auto query = NamedQuery::CreateP_GAME_LoginData_MARS_RU();
+
+		// FixedString 파라미터의 길이를 넘는 값은 잘리므로 실행하지 않는다.
+		if (false == query->SetParameter(loginMode, usn, pid, serverID, serverTime, platform, country, languageCode))
 		{
-			uint8_t loginMode = 0;
-			int64_t usn = 0;
-			std::string pid = "OTEST2020";
-			int32_t serverID = 1001;
-			std::string serverTime = "2022-03-23 12:12:12";
-			std::string platform = "iOS";
-			std::string country = "Kr";
-			std::string languageCode = "Ko";
-
-			auto query = NamedQuery::CreateP_GAME_LoginData_MARS_RU();
-			query->SetParameter(loginMode, usn, pid, serverID, serverTime, platform, country, languageCode);
-
-			auto connection = odbcManager.GetConnection();
-			connection->BindQuery(query);
-			auto executeResultCode = connection->Execute();
-			if (SQL_SUCCESS != executeResultCode)
+			logging->Error("P_GAME_LoginData_MARS_RU parameter is too long.");
+		}
+		else
+		{
+			_odbc_error_ptr_t error;
+			auto executeResultCode = odbcManager.Execute(query.get(), error);
+			if (SQL_SUCCESS != executeResultCode && nullptr != error)
 			{
-				odbcManager.CleanUp(); // Thread Local로 사용될 경우(Single Thread)
-				continue;
+				logging->Error(error->ToString());
 			}
-
-			// 반환
-			odbcManager.Release(std::move(connection));
-			break;
-		} while (true);
+		}
 	}
 
 	// 종료 처리
@@ -489,7 +386,7 @@ int main()
 
 	getchar();
 
-	twh.Stop();
+	executor.Stop();
 
 	return 0;
 }